@@ -0,0 +1,142 @@
+#include "GameContext.h"
+
+#include <random>
+
+#include "utils/Utils.h"
+#include "player/Player.h"
+
+using std::cout;
+
+using cris_utils::getContinueInput;
+
+GameContext::GameContext(ostream *out, bool interactive, unsigned long long seed)
+        : out{out},
+          silentOut{nullptr},
+          interactive{interactive},
+          rng{seed},
+          neutralPlayer{nullptr},
+          pendingBattles{nullptr},
+          moveLog{nullptr} {}
+
+// The context isn't responsible for the neutral player's memory, so it won't perform deep cloning.
+// Pending battles and the move log belong to the game being played, so they aren't shared with the copy
+GameContext::GameContext(const GameContext &other)
+        : out{other.out},
+          silentOut{nullptr},
+          interactive{other.interactive},
+          rng{other.rng},
+          neutralPlayer{other.neutralPlayer},
+          pendingBattles{nullptr},
+          moveLog{nullptr} {}
+
+/**
+ * Swap method. Used for the copy-and-swap idiom
+ *
+ * @param a first element
+ * @param b second element
+ */
+void swap(GameContext &a, GameContext &b) {
+    using std::swap;
+
+    swap(a.out, b.out);
+    swap(a.interactive, b.interactive);
+    swap(a.rng, b.rng);
+    swap(a.neutralPlayer, b.neutralPlayer);
+    swap(a.pendingBattles, b.pendingBattles);
+    swap(a.moveLog, b.moveLog);
+}
+
+GameContext &GameContext::operator=(GameContext other) {
+    swap(*this, other);
+    return *this;
+}
+
+ostream &operator<<(ostream &out, const GameContext &obj) {
+    out << "GameContext{ "
+        << "silent: " << (obj.out == nullptr)
+        << ", interactive: " << obj.interactive
+        << " }";
+    return out;
+}
+
+/**
+ * Returns the stream game output should be written to. Output is discarded if the context has no stream
+ */
+ostream &GameContext::log() {
+    if (out == nullptr) {
+        return silentOut;
+    }
+    return *out;
+}
+
+/**
+ * Waits for the user to press Enter, if the context is interactive
+ */
+void GameContext::pause() {
+    if (interactive) {
+        getContinueInput();
+    }
+}
+
+bool GameContext::isInteractive() const {
+    return interactive;
+}
+
+cris_utils::Random &GameContext::getRng() {
+    return rng;
+}
+
+/**
+ * Returns the player owning the territories which were abandoned by other players
+ *
+ * @see BlockadeOrder
+ */
+Player *GameContext::getNeutralPlayer() const {
+    return neutralPlayer;
+}
+
+void GameContext::setNeutralPlayer(Player *neutralPlayer) {
+    this->neutralPlayer = neutralPlayer;
+}
+
+/**
+ * Returns the batch attacks are queued into instead of being resolved immediately, or null when
+ * attacks are resolved as they are executed
+ */
+CombatBatch *GameContext::getPendingBattles() const {
+    return pendingBattles;
+}
+
+void GameContext::setPendingBattles(CombatBatch *pendingBattles) {
+    this->pendingBattles = pendingBattles;
+}
+
+/**
+ * Returns the log the changes to players and to the deck are recorded in, or null when they aren't
+ * recorded
+ *
+ * @see Map::setMoveLog
+ */
+MoveLog *GameContext::getMoveLog() const {
+    return moveLog;
+}
+
+void GameContext::setMoveLog(MoveLog *moveLog) {
+    this->moveLog = moveLog;
+}
+
+/**
+ * Context used by objects created outside of a game, like in the drivers: output goes to the console
+ * and the user is prompted
+ */
+GameContext &GameContext::standalone() {
+    // Like the context, its neutral player lives until the program ends
+    static GameContext *context = [] {
+        auto *created = new GameContext(&cout, true, std::random_device{}());
+        created->setNeutralPlayer(new Player("Neutral Player", created));
+        return created;
+    }();
+    return *context;
+}
+
+GameContext::~GameContext() {}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <iostream>
+
+#include "utils/Random.h"
+
+using std::ostream;
+
+class Player;
+class CombatBatch;
+class MoveLog;
+
+/**
+ * Settings and services shared by everything taking part in a single game.
+ *
+ * Lets games run unattended: a context without an output stream discards the game's output, and a
+ * non-interactive context never waits for the user.
+ */
+class GameContext {
+private:
+    ostream *out;
+    ostream silentOut;
+    bool interactive;
+    cris_utils::Random rng;
+    Player *neutralPlayer;
+    CombatBatch *pendingBattles;
+    MoveLog *moveLog;
+
+public:
+    GameContext(ostream *out, bool interactive, unsigned long long seed);
+    GameContext(const GameContext &other);
+    friend void swap(GameContext &a, GameContext &b);
+    GameContext &operator=(GameContext other);
+    friend ostream &operator<<(ostream &out, const GameContext &obj);
+
+    ostream &log();
+    void pause();
+    bool isInteractive() const;
+    cris_utils::Random &getRng();
+    Player *getNeutralPlayer() const;
+    CombatBatch *getPendingBattles() const;
+    MoveLog *getMoveLog() const;
+
+    void setNeutralPlayer(Player *neutralPlayer);
+    void setPendingBattles(CombatBatch *pendingBattles);
+    void setMoveLog(MoveLog *moveLog);
+
+    static GameContext &standalone();
+
+    ~GameContext();
+};
@@ -3,22 +3,25 @@
 #include <filesystem>
 #include <algorithm>
 #include <random>
+#include <sstream>
 
 #include "utils/Utils.h"
 #include "map/Map.h"
 #include "player/Player.h"
 #include "map-loader/MapLoader.h"
+#include "map-loader/MapCache.h"
+#include "map-loader/MapPipeline.h"
 #include "cards/Cards.h"
 #include "orders/Orders.h"
+#include "orders/Combat.h"
 #include "player/PlayerStrategies.h"
+#include "GameContext.h"
+#include "utils/ThreadPool.h"
 
 using std::cout;
 using std::cin;
 using std::endl;
-using std::filesystem::recursive_directory_iterator;
-using std::filesystem::directory_entry;
 using std::filesystem::current_path;
-using std::filesystem::path;
 
 using cris_utils::getBoolInput;
 using cris_utils::getIntInput;
@@ -30,11 +33,51 @@ using cris_utils::compare;
 using cris_utils::vectorToSet;
 using cris_utils::pickFromList;
 using cris_utils::printList;
-using cris_utils::getContinueInput;
+using cris_utils::ThreadPool;
 
 namespace {
-    auto rd = std::random_device{};
-    auto rng = std::default_random_engine{rd()};
+    /**
+     * Result of a single game played as part of a batch
+     */
+    struct GameOutcome {
+        bool started = false;
+        // Strategy of each player, in the order they were configured
+        vector<string> strategies;
+        // Index of the winning player, -1 if nobody won
+        int winner = -1;
+    };
+
+    /**
+     * Plays a configured game to completion
+     *
+     * @param config
+     * @return the outcome of the game
+     */
+    GameOutcome playGame(const GameConfig &config) {
+        GameOutcome outcome;
+        Game game;
+        if (!game.gameStart(config)) {
+            return outcome;
+        }
+        outcome.started = true;
+
+        const vector<Player *> &players = game.getPlayers();
+        for (auto &player : players) {
+            std::stringstream strategy;
+            strategy << *player->getStrategy();
+            outcome.strategies.push_back(strategy.str());
+        }
+
+        game.startupPhase();
+        game.mainGameLoop();
+
+        for (int i = 0; i < players.size(); ++i) {
+            if (players[i] == game.getWinner()) {
+                outcome.winner = i;
+            }
+        }
+        return outcome;
+    }
 }
 
 //=============================
@@ -45,18 +88,59 @@ Game::Game() : map{nullptr},
                activePlayers{},
                allPlayers{},
                deck{nullptr},
-               mapLoader{nullptr},
+               context{new GameContext(&cout, true, std::random_device{}())},
+               neutralPlayer{new Player("Neutral Player", context)},
                gameOver{false},
                phase{NoPhase},
-               currentPlayer{nullptr} {}
+               currentPlayer{nullptr},
+               winner{nullptr},
+               round{0},
+               maxRounds{0},
+               batchCombat{false} {
+    context->setNeutralPlayer(neutralPlayer);
+}
 
+/**
+ * Copies a game, with its own map, players and deck. Territories are owned by the copies of their owners.
+ *
+ * Observers aren't copied: they watch the other game, so the copy starts without any.
+ * Pending orders still refer to the other game's territories, so games should be copied between rounds.
+ */
 Game::Game(const Game &other) :
+        Observable(),
         map{new Map(*other.map)},
         activePlayers{vector<Player *>()},
-        deck{nullptr} {
+        allPlayers{vector<Player *>()},
+        deck{other.deck == nullptr ? nullptr : new Deck(*other.deck)},
+        context{new GameContext(*other.context)},
+        neutralPlayer{new Player(*other.neutralPlayer)},
+        gameOver{other.gameOver},
+        phase{other.phase},
+        currentPlayer{nullptr},
+        winner{nullptr},
+        round{other.round},
+        maxRounds{other.maxRounds},
+        batchCombat{other.batchCombat} {
+    context->setNeutralPlayer(neutralPlayer);
+    if (deck != nullptr) {
+        deck->rebind(context);
+    }
+
+    std::map<Player *, Player *> copies{{other.neutralPlayer, neutralPlayer}};
+    for (auto &player : other.allPlayers) {
+        auto *copy = new Player(*player);
+        allPlayers.push_back(copy);
+        copies[player] = copy;
+    }
     for (auto &player : other.activePlayers) {
-        activePlayers.push_back(new Player(*player));
+        activePlayers.push_back(copies[player]);
+    }
+    for (auto &copy : copies) {
+        copy.second->rebind(map, context);
+        copy.second->remapAllies(copies);
     }
+    currentPlayer = copies.count(other.currentPlayer) ? copies[other.currentPlayer] : nullptr;
+    winner = copies.count(other.winner) ? copies[other.winner] : nullptr;
 }
 
 /**
@@ -70,6 +154,17 @@ void swap(Game &a, Game &b) {
 
     swap(a.map, b.map);
     swap(a.activePlayers, b.activePlayers);
+    swap(a.allPlayers, b.allPlayers);
+    swap(a.deck, b.deck);
+    swap(a.context, b.context);
+    swap(a.neutralPlayer, b.neutralPlayer);
+    swap(a.gameOver, b.gameOver);
+    swap(a.phase, b.phase);
+    swap(a.currentPlayer, b.currentPlayer);
+    swap(a.winner, b.winner);
+    swap(a.round, b.round);
+    swap(a.maxRounds, b.maxRounds);
+    swap(a.batchCombat, b.batchCombat);
 }
 
 Game &Game::operator=(Game other) {
@@ -105,56 +200,53 @@ void Game::gameStart() {
     string searchPath = current_path();
 
     // Finding available maps
-    vector<string> maps{};
-    for (auto &item : recursive_directory_iterator(searchPath)) {
-        if (!item.is_directory() && item.path().extension().string() == ".map") {
-            maps.push_back(item.path().string());
-        }
-    }
+    vector<string> maps = findMapFiles(searchPath);
 
     // User picks a map. Map must be valid
     bool mapValid = true;
     string warZoneOption = "WarZone Loader";
     string conquestOption = "Conquest Loader";
-    vector<string> availableLoaders = {warZoneOption, conquestOption};
+    string compiledOption = "Compiled Loader";
+    vector<string> availableLoaders = {warZoneOption, conquestOption, compiledOption};
     do {
         if (!mapValid) {
-            cout << "Map is invalid! Please pick another." << endl;
-            delete mapLoader;
-            delete map;
-            mapLoader = nullptr;
-            map = nullptr;
+            context->log() << "Map is invalid! Please pick another." << endl;
         }
         string mapPath = pickFromList("Maps available under" + searchPath,
                                       "Which map file do you want to load?", maps);
         string choice = pickFromList("Among the following loaders:",
                                      "Which loader should be used for the map you chose?", availableLoaders);
         // Pick loader for map
-        if (choice == warZoneOption) {
-            mapLoader = new MapLoader();
-        } else {
-            mapLoader = new ConquestFileReaderAdapter();
+        MapFormat format = choice == warZoneOption ? MapFormat::WarZone
+                           : choice == conquestOption ? MapFormat::Conquest
+                           : MapFormat::Compiled;
+
+        vector<MapError> errors;
+        shared_ptr<const Map> loaded = MapCache::shared().load(mapPath, format, errors);
+        for (auto &error : errors) {
+            context->log() << error << endl;
+        }
+        mapValid = errors.empty();
+        if (mapValid) {
+            map = new Map(*loaded);
         }
-
-        map = mapLoader->readMapFile(mapPath, path(mapPath).filename());
-        mapValid = map->validate();
 
     } while (!mapValid);
 
 
     // user picks number of players
-    cout << endl;
+    context->log() << endl;
     int numPlayers = getIntInput("How many players are there?", 2, 5);
 
     for (int i = 1; i < numPlayers + 1; ++i) {
-        allPlayers.push_back(new Player("Player " + std::to_string(i)));
+        allPlayers.push_back(new Player("Player " + std::to_string(i), context));
     }
     activePlayers.insert(activePlayers.begin(), allPlayers.begin(), allPlayers.end());
 
     vector<string> possibleStrategies{"Human Strategy", "Aggressive Strategy", "Benevolent Strategy",
                                       "Neutral Strategy"};
     for (auto &player : allPlayers) {
-        cout << endl;
+        context->log() << endl;
         // User picks strategy for each player
         string chosenStrategy = pickFromList("Among these possible player strategies:",
                                              "which strategy should " + player->getName() + " use?",
@@ -170,29 +262,83 @@ void Game::gameStart() {
         }
     }
 
-    // Create deck of cards
-    deck = new Deck();
-    for (int i = 0; i < 5; ++i) {
-        deck->addCard(new BombCard());
-        deck->addCard(new ReinforcementCard());
-        deck->addCard(new BlockadeCard());
-        deck->addCard(new AirliftCard());
-        deck->addCard(new DiplomacyCard());
-    }
+    createDeck();
 
     // User chooses to enable observers
-    cout << endl;
+    context->log() << endl;
     bool phaseObserver = getBoolInput("Do you want to turn on the phase observer?");
     if (phaseObserver) {
         attach(new PhaseObserver(this));
     }
-    cout << endl;
+    context->log() << endl;
     bool gameStatsObserver = getBoolInput("Do you want to turn on the game statistics observer?");
     if (gameStatsObserver) {
         attach(new GameStatisticsObserver(this));
     }
 }
 
+/**
+ * Sets up a new game from a configuration, without user input
+ *
+ * The game doesn't prompt or pause afterwards, so startupPhase and mainGameLoop run to completion on
+ * their own.
+ *
+ * @param config
+ * @return whether the game could be set up. False if the map is invalid or the number of players is
+ * unsupported
+ */
+bool Game::gameStart(const GameConfig &config) {
+    *context = GameContext(config.out, false, config.seed);
+    context->setNeutralPlayer(neutralPlayer);
+    maxRounds = config.maxRounds;
+    batchCombat = config.batchCombat;
+    updateGameState(nullptr, GameStartPhase);
+
+    if (config.strategies.size() < 2 || config.strategies.size() > 5) {
+        context->log() << "Unsupported number of players: " << config.strategies.size() << endl;
+        return false;
+    }
+
+    // Games on the same map share its loaded copy, and only get their own territories
+    vector<MapError> errors;
+    shared_ptr<const Map> loaded = MapCache::shared().load(config.mapPath, config.mapFormat, errors);
+    if (!errors.empty()) {
+        for (auto &error : errors) {
+            context->log() << error << endl;
+        }
+        return false;
+    }
+    map = new Map(*loaded);
+
+    for (int i = 0; i < config.strategies.size(); ++i) {
+        Player *player = new Player("Player " + std::to_string(i + 1), context);
+        player->setStrategy(config.strategies[i](player));
+        allPlayers.push_back(player);
+    }
+    activePlayers.insert(activePlayers.begin(), allPlayers.begin(), allPlayers.end());
+
+    createDeck();
+
+    for (auto &observer : config.observers) {
+        attach(observer(this));
+    }
+    return true;
+}
+
+/**
+ * Creates the deck of cards
+ */
+void Game::createDeck() {
+    deck = new Deck(context);
+    for (int i = 0; i < 5; ++i) {
+        deck->addCard(new BombCard());
+        deck->addCard(new ReinforcementCard());
+        deck->addCard(new BlockadeCard());
+        deck->addCard(new AirliftCard());
+        deck->addCard(new DiplomacyCard());
+    }
+}
+
 /**
  * Handles the initial setup of the game
  */
@@ -200,15 +346,15 @@ void Game::startupPhase() {
     updateGameState(nullptr, StartupPhase);
 
     // Determine order of play for players
-    std::shuffle(activePlayers.begin(), activePlayers.end(), rng);
-    cout << "Here is the order of players:" << endl;
-    printList(activePlayers);
-    cout << endl;
+    context->getRng().shuffle(activePlayers);
+    context->log() << "Here is the order of players:" << endl;
+    printList(activePlayers, context->log());
+    context->log() << endl;
 
     // Assign territories round robin style
     int currentPlayer = 0;
     vector<Territory *> shuffledTerritories = map->getTerritories();
-    std::shuffle(shuffledTerritories.begin(), shuffledTerritories.end(), rng);
+    context->getRng().shuffle(shuffledTerritories);
     for (auto &territory : shuffledTerritories) {
         activePlayers[currentPlayer]->captureTerritory(territory);
         currentPlayer++;
@@ -219,16 +365,16 @@ void Game::startupPhase() {
     // Give initial armies to players
     int initialArmies = INITIAL_ARMIES[activePlayers.size()];
 
-    cout << "Giving each player " << initialArmies << " armies at the start of the game!" << endl;
+    context->log() << "Giving each player " << initialArmies << " armies at the start of the game!" << endl;
     for (auto &player : activePlayers) {
         player->addArmies(initialArmies);
     }
 }
 
 void Game::mainGameLoop() {
-    cout << endl;
-    printTitle("Entering the main game loop!");
-    int round = 0;
+    context->log() << endl;
+    printTitle("Entering the main game loop!", context->log());
+    round = 0;
 
     checkGameState();
 
@@ -245,6 +391,11 @@ void Game::mainGameLoop() {
 
         prepareNextRound();
         round++;
+
+        if (!gameOver && maxRounds > 0 && round >= maxRounds) {
+            context->log() << "Reached the limit of " << maxRounds << " rounds. The game ends without a winner." << endl;
+            gameOver = true;
+        }
     }
 }
 
@@ -257,23 +408,23 @@ void Game::reinforcementPhase() {
         numArmies += ownedTerritories.size() / 3;
         set<Continent *> playerContinents = map->getContinentsControlledByPlayer(player);
 
-        cout << endl << player->getName() << " owns " << ownedTerritories.size()
+        context->log() << endl << player->getName() << " owns " << ownedTerritories.size()
              << " territories (+" << numArmies << "), ";
 
         if (playerContinents.empty()) {
-            cout << "and controls no continents. " << endl;
+            context->log() << "and controls no continents. " << endl;
         } else {
-            cout << "and controls the following continents: " << endl;
+            context->log() << "and controls the following continents: " << endl;
         }
         for (auto &continent : playerContinents) {
-            cout << "\t- " << continent->getName() << ": +" << continent->getArmies() << " armies" << endl;
+            context->log() << "\t- " << continent->getName() << ": +" << continent->getArmies() << " armies" << endl;
             numArmies += continent->getArmies();
         }
-        cout << player->getName() << " armies: " << player->getArmies()
+        context->log() << player->getName() << " armies: " << player->getArmies()
              << " -> " << player->getArmies() + numArmies << " (+" << numArmies << ")" << endl;
         player->addArmies(numArmies);
     }
-    getContinueInput();
+    context->pause();
 }
 
 void Game::issueOrderPhase() {
@@ -295,8 +446,7 @@ void Game::issueOrderPhase() {
  */
 bool deployOrdersRemain(vector<Player *> players) {
     for (auto &player : players) {
-        Order *order = player->getOrders()->getHighestPriorityOrder();
-        if (order != nullptr && order->getType() == OrderType::DEPLOY) {
+        if (player->getOrders()->hasDeployOrders()) {
             return true;
         }
     }
@@ -315,12 +465,49 @@ bool ordersRemain(vector<Player *> players) {
     return false;
 }
 
+/**
+ * Checks if the next order of every player is an advance or an airlift, and no two of them involve
+ * the same territory. Such orders can't affect each other, so their battles can be resolved together.
+ */
+bool nextOrdersAreIndependent(vector<Player *> players) {
+    vector<Territory *> involved;
+    for (auto &player : players) {
+        Order *order = player->getOrders()->getHighestPriorityOrder();
+        if (order == nullptr) {
+            continue;
+        }
+        Territory *origin;
+        Territory *dest;
+        if (auto advance = order->as<AdvanceOrder>()) {
+            origin = advance->origin;
+            dest = advance->dest;
+        } else if (auto airlift = order->as<AirliftOrder>()) {
+            origin = airlift->origin;
+            dest = airlift->dest;
+        } else {
+            return false;
+        }
+        if (contains(involved, origin) || contains(involved, dest) || origin == dest) {
+            return false;
+        }
+        involved.push_back(origin);
+        involved.push_back(dest);
+    }
+    return true;
+}
+
 void Game::executeOrdersPhase() {
+    CombatBatch battles;
     while (ordersRemain(activePlayers)) {
+        // Queue the battles of this turn of orders, when they can be resolved together
+        bool batching = batchCombat && nextOrdersAreIndependent(activePlayers);
+        if (batching) {
+            context->setPendingBattles(&battles);
+        }
         for (int i = 0; i < activePlayers.size(); ++i) {
             OrdersList *ordersList = activePlayers[i]->getOrders();
             if (ordersList->empty()) {
-                cout << activePlayers[i]->getName() << " has no more orders to execute." << endl;
+                context->log() << activePlayers[i]->getName() << " has no more orders to execute." << endl;
                 continue;
             }
 
@@ -329,17 +516,21 @@ void Game::executeOrdersPhase() {
 
             // If the order returned isn't a deploy, then current player doesn't have any deploy orders left.
             if (order->getType() != OrderType::DEPLOY && deployOrdersRemain(activePlayers)) {
-                cout << "Cannot execute " << *order << ". Some Deploy orders haven't yet been executed." << endl;
-                getContinueInput();
+                context->log() << "Cannot execute " << *order << ". Some Deploy orders haven't yet been executed." << endl;
+                context->pause();
                 continue;
             }
             order->execute(map, activePlayers[i]);
 
             // Remove order after executing
             ordersList->remove(order);
-            delete order;
 
-            getContinueInput();
+            context->pause();
+        }
+
+        if (batching) {
+            context->setPendingBattles(nullptr);
+            battles.resolve(context->getRng(), context->log());
         }
     }
 
@@ -349,15 +540,16 @@ void Game::checkGameState() {
     // Check if a player was eliminated
     for (auto &player : allPlayers) {
         if (contains(activePlayers, player) && player->getOwnedTerritories().empty()) {
-            cout << player->getName() << " owns no territories. They will be eliminated" << endl;
+            context->log() << player->getName() << " owns no territories. They will be eliminated" << endl;
             removeElement(activePlayers, player);
         }
     }
 
     // Check if a player won the game
     for (auto &player : activePlayers) {
-        if (vectorToSet(map->getTerritories()) == player->getOwnedTerritories()) {
-            cout << player->getName() << " won the game!" << endl;
+        if (player->getOwnedMask().count() == map->getTerritories().size()) {
+            context->log() << player->getName() << " won the game!" << endl;
+            winner = player;
             gameOver = true;
         }
     }
@@ -380,11 +572,11 @@ void Game::prepareNextRound() {
 
         // Give card if captured territory.
         if (player->isCardDue()) {
-            cout << player->getName() << " captured a territory this round! They will get a card" << endl;
+            context->log() << player->getName() << " captured a territory this round! They will get a card" << endl;
             deck->draw(player->getHand());
         }
     }
-    getContinueInput();
+    context->pause();
 }
 
 /**
@@ -404,6 +596,13 @@ const vector<Player *> &Game::getActivePlayers() const {
     return activePlayers;
 }
 
+/**
+ * Returns every player who took part in the game, in the order they were created
+ */
+const vector<Player *> &Game::getPlayers() const {
+    return allPlayers;
+}
+
 GamePhase Game::getPhase() const {
     return phase;
 }
@@ -412,28 +611,93 @@ Player *Game::getCurrentPlayer() const {
     return currentPlayer;
 }
 
+/**
+ * Returns the player who won the game, or nullptr if nobody has won (yet)
+ */
+Player *Game::getWinner() const {
+    return winner;
+}
+
+int Game::getRound() const {
+    return round;
+}
+
+GameContext &Game::getContext() const {
+    return *context;
+}
+
 Game::~Game() {
     delete map;
     for (auto &player : allPlayers) {
         delete player;
     }
 
+    delete neutralPlayer;
     delete deck;
-    delete mapLoader;
+    delete context;
 }
 
-int main() {
-    cout << std::boolalpha;
-
-    Game *game = new Game();
+//=============================
+// Batch Implementation
+//=============================
 
-    game->gameStart();
-    game->startupPhase();
-    game->mainGameLoop();
-    delete game;
+ostream &operator<<(ostream &out, const BatchResult &obj) {
+    out << "BatchResult{ games: " << obj.games
+        << ", draws: " << obj.draws
+        << ", failed: " << obj.failed << endl;
+    for (auto &mapRecords : obj.records) {
+        out << "\t" << mapRecords.first << ":" << endl;
+        for (auto &record : mapRecords.second) {
+            double winRate = record.second.games == 0 ? 0 : 100.0 * record.second.wins / record.second.games;
+            out << "\t\t" << record.first << ": " << record.second.wins << "/" << record.second.games
+                << " wins (" << winRate << "%)" << endl;
+        }
+    }
+    out << "}" << endl;
+    return out;
 }
 
+/**
+ * Plays a batch of independent games concurrently, and aggregates win rates per map and strategy
+ *
+ * Each game keeps all of its state, including its random engine and neutral player, to itself, so
+ * games can run on separate threads without sharing anything. Output of each game goes wherever its
+ * configuration says, so configurations should usually leave it discarded.
+ *
+ * @param configs configuration of each game
+ * @param numThreads number of games played at the same time
+ * @return aggregated results
+ */
+BatchResult runBatch(const vector<GameConfig> &configs, int numThreads) {
+    vector<GameOutcome> outcomes(configs.size());
+    {
+        ThreadPool pool(numThreads);
+        for (int i = 0; i < configs.size(); ++i) {
+            pool.submit([&configs, &outcomes, i] {
+                outcomes[i] = playGame(configs[i]);
+            });
+        }
+        pool.wait();
+    }
 
-
-
-
+    BatchResult result;
+    for (int i = 0; i < outcomes.size(); ++i) {
+        if (!outcomes[i].started) {
+            result.failed++;
+            continue;
+        }
+        result.games++;
+        if (outcomes[i].winner == -1) {
+            result.draws++;
+        }
+        std::map<string, StrategyRecord> &mapRecords = result.records[configs[i].mapPath];
+        for (int player = 0; player < outcomes[i].strategies.size(); ++player) {
+            StrategyRecord &record = mapRecords[outcomes[i].strategies[player]];
+            record.games++;
+            if (player == outcomes[i].winner) {
+                record.wins++;
+            }
+        }
+    }
+    return result;
+}
@@ -2,16 +2,59 @@
 
 #include <iostream>
 #include <vector>
+#include <string>
+#include <functional>
+#include <map>
 
 #include "observers/GameObservers.h"
+#include "map-loader/MapLoader.h"
 
 using std::ostream;
 using std::vector;
+using std::string;
+using std::function;
 
 class Map;
 class Player;
 class Deck;
-class MapLoader;
+class PlayerStrategy;
+class GameContext;
+class Game;
+
+/**
+ * Creates the strategy of a player
+ */
+typedef function<PlayerStrategy *(Player *)> StrategyFactory;
+
+/**
+ * Creates an observer of a game. The game takes ownership of the observer
+ */
+typedef function<Observer *(Game *)> ObserverFactory;
+
+/**
+ * Configuration for a game which is set up without user input.
+ *
+ * Games configured this way never prompt or pause. Strategies which need user input, like the
+ * HumanPlayerStrategy, shouldn't be used.
+ */
+struct GameConfig {
+    string mapPath;
+    MapFormat mapFormat = MapFormat::WarZone;
+    // Strategy of each player. There must be between 2 and 5 players
+    vector<StrategyFactory> strategies;
+    // Games with the same configuration and seed play out identically
+    unsigned long long seed = 0;
+    // Observers attached to the game, like PhaseObserver or GameStatisticsObserver. They are created
+    // for each game, so one configuration can be used for many games
+    vector<ObserverFactory> observers;
+    // Stream the game is narrated to. The narration is discarded when null
+    ostream *out = nullptr;
+    // Number of rounds after which the game ends without a winner. No limit when 0
+    int maxRounds = 0;
+    // Whether attacks executed in the same turn of orders are resolved together when they don't share
+    // territories. Battles play out the same, but are narrated once every player has executed an order
+    bool batchCombat = false;
+};
 
 /**
  * Describes the current phase of the game
@@ -34,11 +77,18 @@ class Game : public Observable {
     vector<Player *> activePlayers;
     vector<Player *> allPlayers;
     Deck *deck;
-    MapLoader *mapLoader;
+    GameContext *context;
+    Player *neutralPlayer;
 
     bool gameOver;
     GamePhase phase;
     Player *currentPlayer;
+    Player *winner;
+    int round;
+    int maxRounds;
+    bool batchCombat;
+
+    void createDeck();
 public:
     Game();
     Game(const Game &other);
@@ -49,6 +99,7 @@ public:
     Observable *clone() override;
 
     void gameStart();
+    bool gameStart(const GameConfig &config);
     void startupPhase();
     void mainGameLoop();
     void reinforcementPhase();
@@ -60,12 +111,40 @@ public:
 
     Map *getMap() const;
     const vector<Player *> &getActivePlayers() const;
+    const vector<Player *> &getPlayers() const;
     GamePhase getPhase() const;
     Player *getCurrentPlayer() const;
+    Player *getWinner() const;
+    int getRound() const;
+    GameContext &getContext() const;
 
     ~Game();
 };
 
+/**
+ * Number of games a strategy played and won on a map
+ */
+struct StrategyRecord {
+    int games = 0;
+    int wins = 0;
+};
+
+/**
+ * Aggregated results of a batch of games
+ */
+struct BatchResult {
+    int games = 0;
+    int draws = 0;
+    // Games which couldn't be set up, because of an invalid map or number of players
+    int failed = 0;
+    // Records by map path, then by strategy
+    std::map<string, std::map<string, StrategyRecord>> records;
+};
+
+ostream &operator<<(ostream &out, const BatchResult &obj);
+
+BatchResult runBatch(const vector<GameConfig> &configs, int numThreads);
+
 /**
  * Describes the number of armies to give depending on the
  * number of players.
@@ -0,0 +1,280 @@
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <random>
+
+#include "GameEngine.h"
+#include "map-loader/MapCache.h"
+#include "map-loader/MapPipeline.h"
+#include "player/PlayerStrategies.h"
+#include "player/MctsPlayerStrategy.h"
+#include "utils/ThreadPool.h"
+
+using std::cout;
+using std::endl;
+using std::filesystem::is_directory;
+
+using cris_utils::hardwareThreads;
+
+namespace {
+    /**
+     * Returns the factory for a strategy given its name on the command line
+     *
+     * @param name "aggressive", "benevolent", "neutral" or "mcts"
+     * @param factory set to the matching factory
+     * @return whether the name is a known strategy
+     */
+    bool strategyFromName(const string &name, StrategyFactory &factory) {
+        if (name == "aggressive") {
+            factory = [](Player *player) { return new AggressivePlayerStrategy(player); };
+        } else if (name == "benevolent") {
+            factory = [](Player *player) { return new BenevolentPlayerStrategy(player); };
+        } else if (name == "neutral") {
+            factory = [](Player *player) { return new NeutralPlayerStrategy(player); };
+        } else if (name == "mcts") {
+            factory = [](Player *player) { return new MctsPlayerStrategy(player); };
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Returns the map format given its name on the command line
+     *
+     * @param name "warzone", "conquest" or "compiled"
+     * @param format set to the matching format
+     * @return whether the name is a known format
+     */
+    bool formatFromName(const string &name, MapFormat &format) {
+        if (name == "warzone") {
+            format = MapFormat::WarZone;
+        } else if (name == "conquest") {
+            format = MapFormat::Conquest;
+        } else if (name == "compiled") {
+            format = MapFormat::Compiled;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Reads a whole command line argument as an integer
+     *
+     * @param text
+     * @param value set to the integer read
+     * @return whether the whole argument is an integer
+     */
+    bool parseInt(const char *text, int &value) {
+        const char *end = text + std::strlen(text);
+        auto [parsed, error] = std::from_chars(text, end, value);
+        return error == std::errc() && parsed == end && parsed != text;
+    }
+
+    /**
+     * Builds the configurations of a batch of bot games from the command line arguments
+     *
+     * Arguments: <map file> <warzone|conquest|compiled> <games> <threads> <strategy> <strategy>..., after
+     * the mode. Every game gets its own random seed.
+     *
+     * @param configs set to the configuration of each game
+     * @param numThreads set to the number of threads, every core when 0 or less is given
+     * @return whether the arguments are valid. Problems are printed to the console, followed by the usage
+     */
+    bool parseBatchArguments(int argc, char *argv[], vector<GameConfig> &configs, int &numThreads) {
+        GameConfig config;
+        int numGames = 0;
+        string problem;
+        if (argc < 8) {
+            problem = "Not enough arguments";
+        } else if (!formatFromName(argv[3], config.mapFormat)) {
+            problem = "Unknown map format: " + string(argv[3]);
+        } else if (!parseInt(argv[4], numGames) || numGames <= 0) {
+            problem = "The number of games must be a positive integer: " + string(argv[4]);
+        } else if (!parseInt(argv[5], numThreads)) {
+            problem = "The number of threads must be an integer: " + string(argv[5]);
+        }
+        if (!problem.empty()) {
+            cout << problem << endl
+                 << "Usage: " << argv[0] << " " << argv[1]
+                 << " <map file> <warzone|conquest|compiled> <games> <threads> <strategy> <strategy>..." << endl
+                 << "Strategies: aggressive, benevolent, neutral, mcts. A thread count of 0 uses every core." << endl;
+            return false;
+        }
+
+        config.mapPath = argv[2];
+        config.maxRounds = 1000;
+        if (numThreads <= 0) {
+            numThreads = hardwareThreads();
+        }
+        for (int i = 6; i < argc; ++i) {
+            StrategyFactory factory;
+            if (!strategyFromName(argv[i], factory)) {
+                cout << "Unknown strategy: " << argv[i] << endl;
+                return false;
+            }
+            config.strategies.push_back(factory);
+        }
+
+        configs.assign(numGames, config);
+        std::random_device seeds;
+        for (auto &gameConfig : configs) {
+            gameConfig.seed = (static_cast<unsigned long long>(seeds()) << 32) | seeds();
+        }
+        return true;
+    }
+
+    /**
+     * Runs a batch of bot games described by the command line arguments, and prints the win rates
+     *
+     * Usage: GameEngine --batch <map file> <warzone|conquest|compiled> <games> <threads> <strategy> <strategy>...
+     *
+     * @return exit code
+     */
+    int batchMain(int argc, char *argv[]) {
+        vector<GameConfig> configs;
+        int numThreads;
+        if (!parseBatchArguments(argc, argv, configs, numThreads)) {
+            return 1;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        BatchResult result = runBatch(configs, numThreads);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        cout << result;
+        cout << "Played " << result.games << " games on " << numThreads << " threads in " << elapsed.count()
+             << "s (" << result.games / elapsed.count() << " games/s)" << endl
+             << MapCache::shared().getStats() << endl;
+        return 0;
+    }
+
+    /**
+     * Plays the same batch of bot games on 1, 2, 4... threads up to a maximum, and prints the throughput
+     * of each run and its speedup over a single thread
+     *
+     * The map is loaded once before the first run, so every run only measures games being played.
+     *
+     * Usage: GameEngine --scaling <map file> <warzone|conquest|compiled> <games> <max threads> <strategy> <strategy>...
+     *
+     * @return exit code
+     */
+    int scalingMain(int argc, char *argv[]) {
+        vector<GameConfig> configs;
+        int maxThreads;
+        if (!parseBatchArguments(argc, argv, configs, maxThreads)) {
+            return 1;
+        }
+        vector<MapError> errors;
+        MapCache::shared().load(configs[0].mapPath, configs[0].mapFormat, errors);
+        if (!errors.empty()) {
+            for (auto &error : errors) {
+                cout << error << endl;
+            }
+            return 1;
+        }
+
+        cout << configs.size() << " games per run, " << hardwareThreads() << " hardware threads" << endl;
+        double singleThreaded = 0;
+        for (int numThreads = 1; ; numThreads = std::min(numThreads * 2, maxThreads)) {
+            auto start = std::chrono::steady_clock::now();
+            BatchResult result = runBatch(configs, numThreads);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+            double throughput = result.games / elapsed.count();
+            if (numThreads == 1) {
+                singleThreaded = throughput;
+            }
+            cout << numThreads << " threads: " << throughput << " games/s, speedup " << throughput / singleThreaded
+                 << " (" << 100 * throughput / singleThreaded / numThreads << "% of linear)" << endl;
+            if (numThreads == maxThreads) {
+                return 0;
+            }
+        }
+    }
+
+    /**
+     * Loads and validates the map files given on the command line, and prints a report of each map
+     * and the time spent on each stage
+     *
+     * Usage: GameEngine --validate <threads> <map file or directory>...
+     *
+     * @return exit code: 0 if every map is valid
+     */
+    int validateMain(int argc, char *argv[]) {
+        int numThreads = 0;
+        if (argc < 4 || !parseInt(argv[2], numThreads)) {
+            cout << "Usage: " << argv[0] << " --validate <threads> <map file or directory>..." << endl
+                 << "Directories are searched for .map and .cmap files. A thread count of 0 uses every core." << endl;
+            return 1;
+        }
+        if (numThreads <= 0) {
+            numThreads = hardwareThreads();
+        }
+        vector<string> paths;
+        for (int i = 3; i < argc; ++i) {
+            if (is_directory(argv[i])) {
+                vector<string> found = findMapFiles(argv[i]);
+                paths.insert(paths.end(), found.begin(), found.end());
+            } else {
+                paths.push_back(argv[i]);
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        vector<MapReport> reports = loadAndValidateMaps(paths, numThreads);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        int valid = 0;
+        MapStageTimes total;
+        for (auto &report : reports) {
+            cout << (report.valid ? "VALID   " : "INVALID ") << report.path << " (" << report.format << ", "
+                 << report.territories << " territories, " << report.continents << " continents, "
+                 << report.connections << " connections)" << endl;
+            for (auto &error : report.errors) {
+                cout << "\t" << error << endl;
+            }
+            valid += report.valid ? 1 : 0;
+            total.io += report.times.io;
+            total.parse += report.times.parse;
+            total.build += report.times.build;
+        }
+        cout << valid << "/" << reports.size() << " maps valid. Checked on " << numThreads << " threads in "
+             << elapsed.count() << "s" << endl
+             << "Time per stage, summed over the maps: I/O " << total.io << "s, parse and validate " << total.parse
+             << "s, build " << total.build << "s" << endl;
+        return valid == reports.size() ? 0 : 1;
+    }
+}
+
+/**
+ * Driver for the game engine
+ *
+ * Without arguments, plays a game set up interactively. Otherwise runs one of the headless modes: a
+ * batch of bot games, the thread scaling of a batch, or the validation of map files.
+ *
+ * Usage: GameEngine [--batch|--scaling|--validate <arguments>...]
+ */
+int main(int argc, char *argv[]) {
+    cout << std::boolalpha;
+
+    if (argc > 1 && string(argv[1]) == "--batch") {
+        return batchMain(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--scaling") {
+        return scalingMain(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--validate") {
+        return validateMain(argc, argv);
+    }
+
+    Game *game = new Game();
+
+    game->gameStart();
+    game->startupPhase();
+    game->mainGameLoop();
+    delete game;
+}
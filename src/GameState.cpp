@@ -0,0 +1,150 @@
+#include "GameState.h"
+
+#include <algorithm>
+
+#include "GameEngine.h"
+#include "map/Map.h"
+#include "player/Player.h"
+
+using std::find;
+
+using cris_utils::Span;
+
+GameState::GameState()
+        : territoryCount{0},
+          playerCount{0},
+          round{0},
+          data{} {}
+
+/**
+ * Creates an empty snapshot, where every territory is neutral and without armies
+ *
+ * @param territoryCount
+ * @param playerCount
+ */
+GameState::GameState(int territoryCount, int playerCount)
+        : territoryCount{territoryCount},
+          playerCount{playerCount},
+          round{0},
+          data(2 * territoryCount + playerCount, 0) {
+    std::fill(data.begin() + territoryCount, data.begin() + 2 * territoryCount, NEUTRAL);
+}
+
+/**
+ * Takes a snapshot of the state of a map
+ *
+ * Armies are copied straight from the map's territory store, and owners are translated from the
+ * store's registry to indices in the players. Territories owned by anyone else are NEUTRAL.
+ *
+ * @param map
+ * @param players players the snapshot refers to by index
+ * @param round
+ */
+GameState::GameState(const Map &map, const vector<Player *> &players, int round)
+        : GameState(map.getTerritories().size(), players.size()) {
+    this->round = round;
+    const TerritoryStore &store = map.getTerritoryStore();
+
+    Span<int32_t> armies = store.getAllArmies();
+    std::copy(armies.begin(), armies.end(), data.begin());
+
+    // Player index of each owner index of the store, filled as owner indices are met
+    vector<int> playerIndices{};
+    Span<uint16_t> owners = store.getAllOwners();
+    for (int i = 0; i < territoryCount; ++i) {
+        uint16_t ownerIndex = owners[i];
+        while (playerIndices.size() <= ownerIndex) {
+            auto found = find(players.begin(), players.end(), store.getPlayer(playerIndices.size()));
+            playerIndices.push_back(found == players.end() ? NEUTRAL : found - players.begin());
+        }
+        data[territoryCount + i] = playerIndices[ownerIndex];
+    }
+
+    for (int i = 0; i < playerCount; ++i) {
+        data[2 * territoryCount + i] = players[i]->getArmies();
+    }
+}
+
+/**
+ * Takes a snapshot of a game, referring to players by their index in Game::getPlayers
+ *
+ * @param game
+ */
+GameState::GameState(const Game &game)
+        : GameState(*game.getMap(), game.getPlayers(), game.getRound()) {}
+
+ostream &operator<<(ostream &out, const GameState &obj) {
+    out << "GameState{ "
+        << "round: " << obj.round
+        << ", territories: " << obj.territoryCount
+        << ", players: " << obj.playerCount
+        << " }";
+    return out;
+}
+
+int GameState::getTerritoryCount() const {
+    return territoryCount;
+}
+
+int GameState::getPlayerCount() const {
+    return playerCount;
+}
+
+int GameState::getRound() const {
+    return round;
+}
+
+int32_t GameState::getArmies(int territory) const {
+    return data[territory];
+}
+
+/**
+ * Returns the index of the player owning a territory, or NEUTRAL
+ */
+int GameState::getOwner(int territory) const {
+    return data[territoryCount + territory];
+}
+
+/**
+ * Returns the armies a player has left to deploy
+ */
+int32_t GameState::getReinforcements(int player) const {
+    return data[2 * territoryCount + player];
+}
+
+/**
+ * Counts the territories owned by a player
+ */
+int GameState::countOwned(int player) const {
+    return std::count(data.begin() + territoryCount, data.begin() + 2 * territoryCount, player);
+}
+
+/**
+ * Returns the armies of every territory, indexed by territory id
+ */
+Span<int32_t> GameState::getAllArmies() const {
+    return Span<int32_t>(data.data(), data.data() + territoryCount);
+}
+
+/**
+ * Returns the owner of every territory, indexed by territory id
+ */
+Span<int32_t> GameState::getAllOwners() const {
+    return Span<int32_t>(data.data() + territoryCount, data.data() + 2 * territoryCount);
+}
+
+void GameState::setRound(int round) {
+    this->round = round;
+}
+
+void GameState::setArmies(int territory, int32_t armies) {
+    data[territory] = armies;
+}
+
+void GameState::setOwner(int territory, int player) {
+    data[territoryCount + territory] = player;
+}
+
+void GameState::setReinforcements(int player, int32_t armies) {
+    data[2 * territoryCount + player] = armies;
+}
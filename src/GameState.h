@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "utils/Utils.h"
+
+using std::ostream;
+using std::vector;
+
+class Game;
+class Map;
+class Player;
+
+/**
+ * Compact snapshot of the state of a game, used to search ahead without copying the game itself.
+ *
+ * The whole state is a single flat array of integers holding no pointers, so a snapshot is cloned
+ * with one copy of contiguous memory. Players are referred to by their index in Game::getPlayers,
+ * and territories by id. The layout of the map isn't part of the snapshot: the game's map describes
+ * it for every snapshot taken from that game.
+ *
+ * Note that since this class doesn't have pointer attributes, the default
+ * copy constructor, assignment operator and destructor are used
+ */
+class GameState {
+private:
+    int territoryCount;
+    int playerCount;
+    int round;
+    // Armies of each territory, then owner of each territory, then reinforcement pool of each player
+    vector<int32_t> data;
+
+public:
+    // Owner of territories held by the neutral player, or by nobody
+    static constexpr int NEUTRAL = -1;
+
+    GameState();
+    GameState(int territoryCount, int playerCount);
+    GameState(const Map &map, const vector<Player *> &players, int round);
+    explicit GameState(const Game &game);
+    friend ostream &operator<<(ostream &out, const GameState &obj);
+
+    int getTerritoryCount() const;
+    int getPlayerCount() const;
+    int getRound() const;
+    int32_t getArmies(int territory) const;
+    int getOwner(int territory) const;
+    int32_t getReinforcements(int player) const;
+    int countOwned(int player) const;
+    cris_utils::Span<int32_t> getAllArmies() const;
+    cris_utils::Span<int32_t> getAllOwners() const;
+
+    void setRound(int round);
+    void setArmies(int territory, int32_t armies);
+    void setOwner(int territory, int player);
+    void setReinforcements(int player, int32_t armies);
+};
+
+ostream &operator<<(ostream &out, const GameState &obj);
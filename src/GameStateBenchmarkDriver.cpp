@@ -0,0 +1,81 @@
+#include <chrono>
+#include <iostream>
+
+#include "GameEngine.h"
+#include "GameState.h"
+#include "map/Map.h"
+#include "player/PlayerStrategies.h"
+
+using std::cout;
+using std::endl;
+
+namespace {
+    /**
+     * Times copying a value many times, and prints the copies per second
+     *
+     * @param copy makes one copy, returning a value which is summed so the copies aren't optimized away
+     * @return copies per second
+     */
+    template<typename F>
+    double measure(const string &name, long copies, F copy) {
+        long sum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < copies; ++i) {
+            sum += copy(i);
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        double perSecond = copies / elapsed.count();
+        cout << name << ": " << perSecond << " copies/s (" << copies << " in " << elapsed.count()
+             << " s, checksum " << sum << ")" << endl;
+        return perSecond;
+    }
+}
+
+/**
+ * Benchmark for copying game states
+ *
+ * Plays a few rounds of a seeded game between bots, then compares cloning a GameState snapshot of it,
+ * which is what searches copy, with copying the whole Game.
+ *
+ * Usage: GameStateBenchmark [map file] [warzone|conquest] [game copies]
+ * The map defaults to maps/earth-conquest/Earth.map, from the root of the repository.
+ */
+int main(int argc, char *argv[]) {
+    GameConfig config;
+    config.mapPath = argc > 1 ? argv[1] : "maps/earth-conquest/Earth.map";
+    string format = argc > 2 ? argv[2] : "conquest";
+    long gameCopies = argc > 3 ? std::stol(argv[3]) : 20000;
+    if (format != "warzone" && format != "conquest") {
+        cout << "Usage: " << argv[0] << " [map file] [warzone|conquest] [game copies]" << endl;
+        return 1;
+    }
+    config.mapFormat = format == "conquest" ? MapFormat::Conquest : MapFormat::WarZone;
+    config.seed = 1;
+    config.maxRounds = 3;
+    for (int i = 0; i < 2; ++i) {
+        config.strategies.push_back([](Player *player) { return new AggressivePlayerStrategy(player); });
+        config.strategies.push_back([](Player *player) { return new BenevolentPlayerStrategy(player); });
+    }
+
+    Game game;
+    if (!game.gameStart(config)) {
+        cout << "Can't load " << config.mapPath << endl;
+        return 1;
+    }
+    game.startupPhase();
+    game.mainGameLoop();
+    cout << config.mapPath << ": " << game.getMap()->getTerritories().size() << " territories, "
+         << game.getPlayers().size() << " players, copied after round " << game.getRound() << endl;
+
+    GameState snapshot(game);
+    int territories = snapshot.getTerritoryCount();
+    double snapshots = measure("GameState", gameCopies * 1000, [&snapshot, territories](long i) {
+        GameState copy = snapshot;
+        return copy.getArmies(i % territories);
+    });
+    double games = measure("Game", gameCopies, [&game](long i) {
+        Game copy(game);
+        return copy.getRound();
+    });
+    cout << "A snapshot clones " << snapshots / games << " times as fast as a game" << endl;
+}
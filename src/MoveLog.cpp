@@ -0,0 +1,214 @@
+#include "MoveLog.h"
+
+#include "cards/Cards.h"
+#include "map/Map.h"
+#include "player/Player.h"
+
+// Note that the log isn't responsible for the memory of what it refers to, so the default copy
+// constructor, assignment operator and destructor are used
+MoveLog::MoveLog() : changes{}, undone{}, replaying{false} {}
+
+ostream &operator<<(ostream &out, const MoveLog &obj) {
+    out << "MoveLog{ "
+        << "changes: " << obj.changes.size()
+        << ", undone: " << obj.undone.size()
+        << " }";
+    return out;
+}
+
+/**
+ * Returns a checkpoint which the state can later be restored to
+ *
+ * @see undo
+ */
+int MoveLog::checkpoint() const {
+    return changes.size();
+}
+
+/**
+ * Undoes the changes made since a checkpoint, latest first. They can be redone until the next undo or
+ * the next recorded change
+ *
+ * @param checkpoint
+ */
+void MoveLog::undo(int checkpoint) {
+    undone.clear();
+    replaying = true;
+    while (changes.size() > checkpoint) {
+        revert(changes.back());
+        undone.push_back(changes.back());
+        changes.pop_back();
+    }
+    replaying = false;
+}
+
+/**
+ * Redoes the changes undone by the last undo, in the order they were made
+ */
+void MoveLog::redo() {
+    replaying = true;
+    while (!undone.empty()) {
+        reapply(undone.back());
+        changes.push_back(undone.back());
+        undone.pop_back();
+    }
+    replaying = false;
+}
+
+/**
+ * Forgets every change, keeping the current state
+ */
+void MoveLog::clear() {
+    changes.clear();
+    undone.clear();
+}
+
+int MoveLog::size() const {
+    return changes.size();
+}
+
+bool MoveLog::canRedo() const {
+    return !undone.empty();
+}
+
+void MoveLog::recordArmies(TerritoryStore *store, int id, int32_t before, int32_t after) {
+    record({ChangeType::ARMIES, store, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, id, before, after});
+}
+
+void MoveLog::recordReservedArmies(TerritoryStore *store, int id, int32_t before, int32_t after) {
+    record({ChangeType::RESERVED_ARMIES, store, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, id, before,
+            after});
+}
+
+void MoveLog::recordOwner(TerritoryStore *store, int id, uint16_t before, uint16_t after) {
+    record({ChangeType::OWNER, store, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, id, before, after});
+}
+
+void MoveLog::recordOwnedAdded(Player *player, Territory *territory) {
+    record({ChangeType::OWNED_ADDED, nullptr, player, territory, nullptr, nullptr, nullptr, nullptr, 0, 0, 0});
+}
+
+void MoveLog::recordOwnedRemoved(Player *player, Territory *territory) {
+    record({ChangeType::OWNED_REMOVED, nullptr, player, territory, nullptr, nullptr, nullptr, nullptr, 0, 0, 0});
+}
+
+void MoveLog::recordPlayerArmies(Player *player, int before, int after) {
+    record({ChangeType::PLAYER_ARMIES, nullptr, player, nullptr, nullptr, nullptr, nullptr, nullptr, 0, before,
+            after});
+}
+
+void MoveLog::recordCardDue(Player *player, bool before, bool after) {
+    record({ChangeType::CARD_DUE, nullptr, player, nullptr, nullptr, nullptr, nullptr, nullptr, 0, before, after});
+}
+
+void MoveLog::recordAllyAdded(Player *player, Player *ally) {
+    record({ChangeType::ALLY_ADDED, nullptr, player, nullptr, ally, nullptr, nullptr, nullptr, 0, 0, 0});
+}
+
+void MoveLog::recordCardDrawn(Deck *deck, Hand *hand, Card *card, int position) {
+    record({ChangeType::CARD_DRAWN, nullptr, nullptr, nullptr, nullptr, deck, hand, card, position, 0, 0});
+}
+
+void MoveLog::recordPlayerRegistered(TerritoryStore *store, Player *player) {
+    record({ChangeType::PLAYER_REGISTERED, store, player, nullptr, nullptr, nullptr, nullptr, nullptr, 0, 0, 0});
+}
+
+void MoveLog::recordContinentCountsGrown(Player *player, int before, int after) {
+    record({ChangeType::CONTINENT_COUNTS_GROWN, nullptr, player, nullptr, nullptr, nullptr, nullptr, nullptr, 0,
+            before, after});
+}
+
+/**
+ * Appends a change. A new change makes the undone changes impossible to redo
+ */
+void MoveLog::record(const Change &change) {
+    if (replaying) {
+        return;
+    }
+    changes.push_back(change);
+    undone.clear();
+}
+
+/**
+ * Restores the state from before a change
+ */
+void MoveLog::revert(const Change &change) {
+    switch (change.type) {
+        case ChangeType::ARMIES:
+            change.store->setArmies(change.index, change.before);
+            break;
+        case ChangeType::RESERVED_ARMIES:
+            change.store->setReservedArmies(change.index, change.before);
+            break;
+        case ChangeType::OWNER:
+            change.store->setOwner(change.index, change.store->getPlayer(change.before));
+            break;
+        case ChangeType::OWNED_ADDED:
+            change.player->removeOwned(change.territory);
+            break;
+        case ChangeType::OWNED_REMOVED:
+            change.player->addOwned(change.territory);
+            break;
+        case ChangeType::PLAYER_ARMIES:
+            change.player->armies = change.before;
+            break;
+        case ChangeType::CARD_DUE:
+            change.player->cardDue = change.before;
+            break;
+        case ChangeType::ALLY_ADDED:
+            change.player->allies.erase(change.ally);
+            break;
+        case ChangeType::CARD_DRAWN:
+            change.hand->removeCard(change.card);
+            change.deck->cards.insert(change.deck->cards.begin() + change.index, change.card);
+            break;
+        case ChangeType::PLAYER_REGISTERED:
+            change.store->unregisterLastPlayer();
+            break;
+        case ChangeType::CONTINENT_COUNTS_GROWN:
+            change.player->continentCounts.resize(change.before);
+            break;
+    }
+}
+
+/**
+ * Makes a change again, after it was reverted
+ */
+void MoveLog::reapply(const Change &change) {
+    switch (change.type) {
+        case ChangeType::ARMIES:
+            change.store->setArmies(change.index, change.after);
+            break;
+        case ChangeType::RESERVED_ARMIES:
+            change.store->setReservedArmies(change.index, change.after);
+            break;
+        case ChangeType::OWNER:
+            change.store->setOwner(change.index, change.store->getPlayer(change.after));
+            break;
+        case ChangeType::OWNED_ADDED:
+            change.player->addOwned(change.territory);
+            break;
+        case ChangeType::OWNED_REMOVED:
+            change.player->removeOwned(change.territory);
+            break;
+        case ChangeType::PLAYER_ARMIES:
+            change.player->armies = change.after;
+            break;
+        case ChangeType::CARD_DUE:
+            change.player->cardDue = change.after;
+            break;
+        case ChangeType::ALLY_ADDED:
+            change.player->allies.insert(change.ally);
+            break;
+        case ChangeType::CARD_DRAWN:
+            change.deck->cards.erase(change.deck->cards.begin() + change.index);
+            change.hand->addCard(change.card);
+            break;
+        case ChangeType::PLAYER_REGISTERED:
+            change.store->registerPlayer(change.player);
+            break;
+        case ChangeType::CONTINENT_COUNTS_GROWN:
+            change.player->continentCounts.resize(change.after, 0);
+            break;
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+using std::ostream;
+using std::vector;
+
+class TerritoryStore;
+class Territory;
+class Player;
+class Deck;
+class Hand;
+class Card;
+
+/**
+ * Journal of the changes made to a game, which can be undone and redone.
+ *
+ * Lets a search play an order on the real game, look at the result and take it back, at a cost
+ * proportional to the number of changes instead of the size of the game. The territory store, the
+ * players and the deck record their changes in the log attached to them (see Map::setMoveLog and
+ * GameContext::setMoveLog), as the state before and after each change:
+ * - armies and reserved armies of a territory, the owner of a territory, and players given an owner
+ *   index by the store;
+ * - territories added to or removed from a player, a player's armies, allies and card due flag, and the
+ *   growth of their continent counts;
+ * - cards drawn from the deck.
+ *
+ * Undoing restores the state as it was at a checkpoint, down to the owner indices and the number of
+ * continents counted by each player. The generator isn't part of the log: drawing a card or fighting a
+ * battle still advances it. Neither are the words of a player's owned mask, which keeps its size once
+ * grown, with the same bits set.
+ */
+class MoveLog {
+private:
+    enum class ChangeType {
+        ARMIES,
+        RESERVED_ARMIES,
+        OWNER,
+        OWNED_ADDED,
+        OWNED_REMOVED,
+        PLAYER_ARMIES,
+        CARD_DUE,
+        ALLY_ADDED,
+        CARD_DRAWN,
+        PLAYER_REGISTERED,
+        CONTINENT_COUNTS_GROWN,
+    };
+
+    /**
+     * One change. Only the fields needed by its type are set
+     */
+    struct Change {
+        ChangeType type;
+        TerritoryStore *store;
+        Player *player;
+        Territory *territory;
+        Player *ally;
+        Deck *deck;
+        Hand *hand;
+        Card *card;
+        // Territory id, or position of a drawn card in the deck
+        int index;
+        // Values before and after the change, or sizes of the continent counts
+        int32_t before;
+        int32_t after;
+    };
+
+    vector<Change> changes;
+    vector<Change> undone;
+    // Set while changes are replayed, so replaying doesn't record them again
+    bool replaying;
+
+    void record(const Change &change);
+    void revert(const Change &change);
+    void reapply(const Change &change);
+
+public:
+    MoveLog();
+    friend ostream &operator<<(ostream &out, const MoveLog &obj);
+
+    int checkpoint() const;
+    void undo(int checkpoint);
+    void redo();
+    void clear();
+    int size() const;
+    bool canRedo() const;
+
+    void recordArmies(TerritoryStore *store, int id, int32_t before, int32_t after);
+    void recordReservedArmies(TerritoryStore *store, int id, int32_t before, int32_t after);
+    void recordOwner(TerritoryStore *store, int id, uint16_t before, uint16_t after);
+    void recordOwnedAdded(Player *player, Territory *territory);
+    void recordOwnedRemoved(Player *player, Territory *territory);
+    void recordPlayerArmies(Player *player, int before, int after);
+    void recordCardDue(Player *player, bool before, bool after);
+    void recordAllyAdded(Player *player, Player *ally);
+    void recordCardDrawn(Deck *deck, Hand *hand, Card *card, int position);
+    void recordPlayerRegistered(TerritoryStore *store, Player *player);
+    void recordContinentCountsGrown(Player *player, int before, int after);
+};
+
+ostream &operator<<(ostream &out, const MoveLog &obj);
@@ -0,0 +1,251 @@
+#include <iostream>
+#include <sstream>
+
+#include "GameContext.h"
+#include "MoveLog.h"
+#include "cards/Cards.h"
+#include "map/Map.h"
+#include "map/MapGenerator.h"
+#include "orders/Orders.h"
+#include "player/Player.h"
+
+using std::cout;
+using std::endl;
+using std::stringstream;
+
+using cris_utils::Random;
+
+namespace {
+    // Largest random map played on, small enough to play many steps on every territory
+    const int MAX_TERRITORIES = 60;
+
+    /**
+     * Describes everything the log is meant to restore, one fact per line: the territories and the
+     * owner indices of the store, then each player's armies, territories, continent counts, allies and
+     * hand, then the deck
+     */
+    string describe(Map &map, const vector<Player *> &players, Deck &deck) {
+        stringstream out;
+        const TerritoryStore &store = map.getTerritoryStore();
+        out << "owner indices: " << store.getPlayerCount() << endl;
+        for (int i = 1; i < store.getPlayerCount(); ++i) {
+            out << "owner index " << i << ": " << store.getPlayer(i)->getName() << endl;
+        }
+        for (int id = 0; id < store.size(); ++id) {
+            out << "territory " << id << ": armies " << store.getArmies(id) << ", reserved "
+                << store.getReservedArmies(id) << ", owner index " << store.getOwnerIndex(id) << endl;
+        }
+
+        for (auto &player : players) {
+            out << *player << endl;
+            out << player->getName() << " owns:";
+            for (auto &territory : player->getOwnedTerritories()) {
+                out << " " << territory->getId();
+            }
+            out << endl << player->getName() << " mask:";
+            for (int id = 0; id < store.size(); ++id) {
+                out << (player->getOwnedMask().test(id) ? "1" : "0");
+            }
+            out << " (" << player->getOwnedMask().count() << ")" << endl;
+            out << player->getName() << " continents:";
+            for (auto &continent : map.getContinents()) {
+                out << " " << player->getTerritoryCount(continent);
+            }
+            out << endl << player->getName() << " allies:";
+            for (auto &ally : player->getAllies()) {
+                out << " " << ally->getName();
+            }
+            out << endl << player->getName() << " hand:";
+            for (auto &card : player->getHand()->getCards()) {
+                out << " " << static_cast<void *>(card);
+            }
+            out << endl;
+        }
+        out << deck;
+        return out.str();
+    }
+
+    /**
+     * Makes a random change to the game: executes a random order, captures or loses a territory, draws a
+     * card, or changes armies directly
+     */
+    void playRandomly(Map &map, const vector<Player *> &players, Deck &deck, Random &rng) {
+        const vector<Territory *> &territories = map.getTerritories();
+        Territory *territory = territories[rng.nextInt(0, territories.size() - 1)];
+        Territory *other = territories[rng.nextInt(0, territories.size() - 1)];
+        Player *player = players[rng.nextInt(0, players.size() - 1)];
+        Player *otherPlayer = players[rng.nextInt(0, players.size() - 1)];
+        if (!player->getOwnedTerritories().empty()) {
+            // Orders are mostly issued from a territory of the player
+            auto owned = player->getOwnedTerritories().begin();
+            std::advance(owned, rng.nextInt(0, player->getOwnedTerritories().size() - 1));
+            territory = *owned;
+        }
+        cris_utils::Span<Territory *> neighbors = map.getNeighbors(territory);
+        Territory *neighbor = neighbors[rng.nextInt(0, neighbors.size() - 1)];
+        int armies = rng.nextInt(0, territory->getArmies() + 1);
+
+        switch (rng.nextInt(0, 11)) {
+            case 0:
+            case 1: {
+                Order order = AdvanceOrder{armies, territory, neighbor};
+                order.execute(&map, player);
+                break;
+            }
+            case 2: {
+                Order order = AirliftOrder{armies, territory, other};
+                order.execute(&map, player);
+                break;
+            }
+            case 3: {
+                Order order = BombOrder{other};
+                order.execute(&map, player);
+                break;
+            }
+            case 4: {
+                Order order = BlockadeOrder{territory};
+                order.execute(&map, player);
+                break;
+            }
+            case 5: {
+                Order order = NegotiateOrder{otherPlayer};
+                order.execute(&map, player);
+                break;
+            }
+            case 6:
+                player->captureTerritory(other);
+                break;
+            case 7:
+                other->getPlayer()->loseTerritory(other);
+                break;
+            case 8:
+                deck.draw(player->getHand());
+                break;
+            case 9:
+                player->addArmies(rng.nextInt(1, 10));
+                player->setCardDue(!player->isCardDue());
+                break;
+            case 10:
+                territory->reserveArmies(rng.nextInt(0, territory->getAvailableArmies()));
+                break;
+            default:
+                other->addArmies(rng.nextInt(1, 10));
+                break;
+        }
+    }
+
+    /**
+     * Prints the first line which differs between two descriptions
+     */
+    void printDifference(const string &expected, const string &actual) {
+        stringstream expectedLines(expected);
+        stringstream actualLines(actual);
+        string expectedLine;
+        string actualLine;
+        while (std::getline(expectedLines, expectedLine)) {
+            if (!std::getline(actualLines, actualLine)) {
+                actualLine = "";
+            }
+            if (expectedLine != actualLine) {
+                cout << "\texpected: " << expectedLine << endl << "\tactual:   " << actualLine << endl;
+                return;
+            }
+        }
+        cout << "\tunexpected extra lines" << endl;
+    }
+}
+
+/**
+ * Driver checking that MoveLog restores the game exactly
+ *
+ * On random maps, gives territories and cards to some players, then plays random changes and orders
+ * with a log attached and undoes them. The state after undoing must be identical to the state at the
+ * checkpoint: territories, owner indices of the store (players owning their first territory get a new
+ * one), each player's territories, owned mask, continent counts and the size of the vector holding them,
+ * allies and hand, and the cards left in the deck. Redoing must then give back the state before undoing.
+ * Exits with 1 on the first difference.
+ *
+ * Usage: MoveLog [games] [seed]
+ */
+int main(int argc, char *argv[]) {
+    int numGames = argc > 1 ? std::stoi(argv[1]) : 300;
+    unsigned long long seed = argc > 2 ? std::stoull(argv[2]) : 1;
+    Random rng(seed);
+
+    long changes = 0;
+    for (int game = 0; game < numGames; ++game) {
+        // Continents are used in random order, so players have to grow their continent counts
+        Map map = generateRandomMap(rng, MAX_TERRITORIES, true);
+        GameContext context(nullptr, false, rng.next());
+        Player neutralPlayer("Neutral Player", &context);
+        context.setNeutralPlayer(&neutralPlayer);
+        vector<Player *> players;
+        int numPlayers = rng.nextInt(2, 5);
+        for (int i = 0; i < numPlayers; ++i) {
+            players.push_back(new Player("Player " + std::to_string(i + 1), &context));
+        }
+
+        Deck deck(&context);
+        for (int i = 0; i < 10; ++i) {
+            deck.addCard(new BombCard());
+            deck.addCard(new ReinforcementCard());
+            deck.addCard(new BlockadeCard());
+            deck.addCard(new AirliftCard());
+            deck.addCard(new DiplomacyCard());
+        }
+
+        // The last player and the neutral player start without territories, so the store registers them
+        // while playing
+        for (auto &territory : map.getTerritories()) {
+            players[rng.nextInt(0, numPlayers - 2)]->captureTerritory(territory);
+        }
+        for (int i = 0; i < numPlayers - 1; ++i) {
+            deck.draw(players[i]->getHand());
+        }
+        players.push_back(&neutralPlayer);
+
+        MoveLog moveLog;
+        map.setMoveLog(&moveLog);
+        context.setMoveLog(&moveLog);
+        string before = describe(map, players, deck);
+        int checkpoint = moveLog.checkpoint();
+
+        int steps = rng.nextInt(1, 3 * map.getTerritories().size());
+        for (int step = 0; step < steps; ++step) {
+            playRandomly(map, players, deck, rng);
+        }
+        changes += moveLog.size() - checkpoint;
+        string played = describe(map, players, deck);
+
+        moveLog.undo(checkpoint);
+        string undone = describe(map, players, deck);
+        bool valid = undone == before;
+        if (!valid) {
+            cout << "Game " << game << " (seed " << seed << "): undoing " << steps
+                 << " steps didn't restore the state" << endl;
+            printDifference(before, undone);
+        } else {
+            moveLog.redo();
+            string redone = describe(map, players, deck);
+            valid = redone == played;
+            if (!valid) {
+                cout << "Game " << game << " (seed " << seed << "): redoing " << steps
+                     << " steps didn't replay the state" << endl;
+                printDifference(played, redone);
+            }
+        }
+
+        map.setMoveLog(nullptr);
+        context.setMoveLog(nullptr);
+        for (int i = 0; i < numPlayers; ++i) {
+            delete players[i];
+        }
+        if (!valid) {
+            return 1;
+        }
+    }
+
+    cout << "Undoing restored the state in " << numGames << " games, over " << changes << " recorded changes"
+         << endl;
+    return 0;
+}
@@ -5,6 +5,8 @@
 #include "../orders/Orders.h"
 #include "../utils/Utils.h"
 #include "../player/Player.h"
+#include "../GameContext.h"
+#include "../MoveLog.h"
 
 using std::endl;
 using std::remove;
@@ -20,10 +22,18 @@ using cris_utils::removeElement;
 // Deck Implementation
 //=============================
 
-Deck::Deck() : cards{} {}
+Deck::Deck() : Deck(&GameContext::standalone()) {}
+
+/**
+ * Creates a deck for the game described by the given context
+ *
+ * @param context
+ */
+Deck::Deck(GameContext *context) : cards{}, context{context} {}
 
 Deck::Deck(const Deck &other)
-        : cards{vector<Card *>{}} {
+        : cards{vector<Card *>{}},
+          context{other.context} {
     for (const auto &card : other.cards) {
         cards.push_back(card->clone());
     }
@@ -39,6 +49,7 @@ void swap(Deck &a, Deck &b) {
     using std::swap;
 
     swap(a.cards, b.cards);
+    swap(a.context, b.context);
 }
 
 Deck &Deck::operator=(Deck other) {
@@ -57,22 +68,37 @@ ostream &operator<<(ostream &out, const Deck &obj) {
 }
 
 /**
- * Picks a random cards and puts it to the given hand.
+ * Picks a random cards and puts it to the given hand. Does nothing if the deck is empty.
  * @param hand
  */
 void Deck::draw(Hand *hand) {
-    int picked = randInt(0, cards.size() - 1);
+    if (cards.empty()) {
+        return;
+    }
+    int picked = randInt(0, cards.size() - 1, context->getRng());
 
     Card *pickedCard = cards[picked];
     removeElement(cards, pickedCard);
 
     hand->addCard(pickedCard);
+    if (context->getMoveLog() != nullptr) {
+        context->getMoveLog()->recordCardDrawn(this, hand, pickedCard, picked);
+    }
 }
 
 void Deck::addCard(Card *card) {
     cards.push_back(card);
 }
 
+/**
+ * Draws cards for the game described by another context. Used when a deck is copied for a copy of its game
+ *
+ * @param context
+ */
+void Deck::rebind(GameContext *context) {
+    this->context = context;
+}
+
 Deck::~Deck() {
     for (auto card : cards) {
         delete card;
@@ -181,7 +207,7 @@ Card::~Card() {}
  * @param players
  * @return A new BombOrder
  */
-Order *BombCard::play(Player *cardPlayer, Deck *deck, Map *map, vector<Player *> players) {
+Order BombCard::play(Player *cardPlayer, Deck *deck, Map *map, vector<Player *> players) {
 
     deck->addCard(this);
     cardPlayer->getHand()->removeCard(this);
@@ -189,7 +215,7 @@ Order *BombCard::play(Player *cardPlayer, Deck *deck, Map *map, vector<Player *>
     vector<Territory *> neighbors = cardPlayer->getNeighboringTerritories(map);
     Territory *origin = pickFromList("Among these enemy neighbors:", "Which should be bombed?", neighbors);
 
-    return new BombOrder(origin);
+    return BombOrder{origin};
 }
 
 /**
@@ -226,7 +252,7 @@ void BombCard::print(ostream &out) const {
  * @param players
  * @return A new DeployOrder
  */
-Order *ReinforcementCard::play(Player *cardPlayer, Deck *deck, Map *map, vector<Player *> players) {
+Order ReinforcementCard::play(Player *cardPlayer, Deck *deck, Map *map, vector<Player *> players) {
     deck->addCard(this);
     cardPlayer->getHand()->removeCard(this);
 
@@ -237,7 +263,7 @@ Order *ReinforcementCard::play(Player *cardPlayer, Deck *deck, Map *map, vector<
 
     target->addArmies(5);
 
-    return new DeployOrder(5, target);
+    return DeployOrder{5, target};
 }
 
 /**
@@ -272,7 +298,7 @@ void ReinforcementCard::print(ostream &out) const {
  * @param players
  * @return A new BlockadeOrder
  */
-Order *BlockadeCard::play(Player *cardPlayer, Deck *deck, Map *map, vector<Player *> players) {
+Order BlockadeCard::play(Player *cardPlayer, Deck *deck, Map *map, vector<Player *> players) {
     deck->addCard(this);
     cardPlayer->getHand()->removeCard(this);
 
@@ -281,7 +307,7 @@ Order *BlockadeCard::play(Player *cardPlayer, Deck *deck, Map *map, vector<Playe
                                      "Which should be blockaded?",
                                      ownedTerritories);
 
-    return new BlockadeOrder(target);
+    return BlockadeOrder{target};
 }
 
 /**
@@ -316,7 +342,7 @@ void BlockadeCard::print(ostream &out) const {
  * @param players
  * @return A new AirliftOrder
  */
-Order *AirliftCard::play(Player *cardPlayer, Deck *deck, Map *map, vector<Player *> players) {
+Order AirliftCard::play(Player *cardPlayer, Deck *deck, Map *map, vector<Player *> players) {
     deck->addCard(this);
     cardPlayer->getHand()->removeCard(this);
 
@@ -338,7 +364,7 @@ Order *AirliftCard::play(Player *cardPlayer, Deck *deck, Map *map, vector<Player
     int armies = getIntInput("How many armies do you want to send?", 1, origin->getAvailableArmies());
 
     origin->reserveArmies(armies);
-    return new AirliftOrder(armies, origin, dest);
+    return AirliftOrder{armies, origin, dest};
 }
 
 /**
@@ -373,7 +399,7 @@ void AirliftCard::print(ostream &out) const {
  * @param players
  * @return A new NegotiateOrder
  */
-Order *DiplomacyCard::play(Player *cardPlayer, Deck *deck, Map *map, vector<Player *> activePlayers) {
+Order DiplomacyCard::play(Player *cardPlayer, Deck *deck, Map *map, vector<Player *> activePlayers) {
     deck->addCard(this);
     cardPlayer->getHand()->removeCard(this);
 
@@ -382,7 +408,7 @@ Order *DiplomacyCard::play(Player *cardPlayer, Deck *deck, Map *map, vector<Play
     Player *targetPlayer = pickFromList("Among the players still in the game:", "Who do you want to negotiate with?",
                                         activePlayers);
 
-    return new NegotiateOrder(targetPlayer);
+    return NegotiateOrder{targetPlayer};
 }
 
 /**
@@ -12,6 +12,7 @@ class Player;
 class Hand;
 class Order;
 class Territory;
+class GameContext;
 
 /**
  * Deck which contains a finite list of cards.
@@ -20,9 +21,11 @@ class Territory;
 class Deck {
 private:
     vector<Card *> cards;
+    GameContext *context;
 
 public:
     Deck();
+    Deck(GameContext *context);
     Deck(const Deck &other);
     friend void swap(Deck &a, Deck &b);
     Deck &operator=(Deck other);
@@ -30,8 +33,13 @@ public:
 
     void draw(Hand *hand);
     void addCard(Card *card);
+    void rebind(GameContext *context);
 
     ~Deck();
+
+private:
+    // Puts drawn cards back when undoing
+    friend class MoveLog;
 };
 
 /**
@@ -68,10 +76,10 @@ class Card {
 public:
     friend ostream &operator<<(ostream &out, const Card &obj);
 
-    virtual Order *play(Player *cardPlayer,
-                        Deck *deck,
-                        Map *map,
-                        vector<Player *> players) = 0;
+    virtual Order play(Player *cardPlayer,
+                       Deck *deck,
+                       Map *map,
+                       vector<Player *> players) = 0;
     virtual Card *clone() = 0;
     virtual void print(ostream &out) const = 0;
 
@@ -88,10 +96,10 @@ public:
  */
 class BombCard : public Card {
 public:
-    Order *play(Player *cardPlayer,
-                Deck *deck,
-                Map *map,
-                vector<Player *> players) override;
+    Order play(Player *cardPlayer,
+               Deck *deck,
+               Map *map,
+               vector<Player *> players) override;
     Card *clone() override;
     void print(ostream &out) const override;
 };
@@ -106,10 +114,10 @@ public:
  */
 class ReinforcementCard : public Card {
 public:
-    Order *play(Player *cardPlayer,
-                Deck *deck,
-                Map *map,
-                vector<Player *> players) override;
+    Order play(Player *cardPlayer,
+               Deck *deck,
+               Map *map,
+               vector<Player *> players) override;
     Card *clone() override;
     void print(ostream &out) const override;
 };
@@ -124,10 +132,10 @@ public:
  */
 class BlockadeCard : public Card {
 public:
-    Order *play(Player *cardPlayer,
-                Deck *deck,
-                Map *map,
-                vector<Player *> players) override;
+    Order play(Player *cardPlayer,
+               Deck *deck,
+               Map *map,
+               vector<Player *> players) override;
     Card *clone() override;
     void print(ostream &out) const override;
 };
@@ -142,10 +150,10 @@ public:
  */
 class AirliftCard : public Card {
 public:
-    Order *play(Player *cardPlayer,
-                Deck *deck,
-                Map *map,
-                vector<Player *> players) override;
+    Order play(Player *cardPlayer,
+               Deck *deck,
+               Map *map,
+               vector<Player *> players) override;
     Card *clone() override;
     void print(ostream &out) const override;
 };
@@ -160,10 +168,10 @@ public:
  */
 class DiplomacyCard : public Card {
 public:
-    Order *play(Player *cardPlayer,
-                Deck *deck,
-                Map *map,
-                vector<Player *> activePlayers) override;
+    Order play(Player *cardPlayer,
+               Deck *deck,
+               Map *map,
+               vector<Player *> activePlayers) override;
     Card *clone() override;
     void print(ostream &out) const override;
 };
@@ -54,11 +54,11 @@ int main() {
     cout << *deck << endl;
     cout << *hand << endl;
 
-    cout << *order1 << endl;
-    cout << *order2 << endl;
-    cout << *order3 << endl;
-    cout << *order4 << endl;
-    cout << *order5 << endl;
+    cout << order1 << endl;
+    cout << order2 << endl;
+    cout << order3 << endl;
+    cout << order4 << endl;
+    cout << order5 << endl;
 
     delete deck;
 
@@ -67,10 +67,4 @@ int main() {
     }
 
     delete map;
-
-    delete order1;
-    delete order2;
-    delete order3;
-    delete order4;
-    delete order5;
 }
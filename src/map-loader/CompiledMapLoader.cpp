@@ -0,0 +1,240 @@
+#include "CompiledMapLoader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+#include "../map/Map.h"
+
+using std::ofstream;
+using std::unordered_map;
+using std::vector;
+
+using cris_utils::Span;
+
+namespace {
+    const char MAGIC[4] = {'R', 'W', 'M', 'C'};
+
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t continentCount;
+        uint32_t territoryCount;
+        uint32_t adjacencyCount;
+        uint32_t nameBytes;
+        uint32_t fileSize;
+    };
+
+    struct ContinentEntry {
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        int32_t armyValue;
+    };
+
+    struct TerritoryEntry {
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        int32_t continent;
+        int32_t armies;
+    };
+
+    static_assert(sizeof(Header) % 4 == 0 && sizeof(ContinentEntry) % 4 == 0 && sizeof(TerritoryEntry) % 4 == 0,
+                  "Sections of a compiled map must keep 32 bit values aligned");
+
+    /**
+     * Returns whether a name lies within the name blob
+     */
+    bool nameInBlob(uint32_t offset, uint32_t length, uint32_t nameBytes) {
+        return offset <= nameBytes && length <= nameBytes - offset;
+    }
+
+    /**
+     * Returns the offset of a name in the name blob, appending it if it wasn't seen yet
+     */
+    uint32_t internName(const string &name, string &blob, unordered_map<string, uint32_t> &offsets) {
+        auto found = offsets.find(name);
+        if (found != offsets.end()) {
+            return found->second;
+        }
+        uint32_t offset = blob.size();
+        blob += name;
+        offsets.emplace(name, offset);
+        return offset;
+    }
+}
+
+//=============================
+// CompiledMapLoader Implementation
+//=============================
+
+ostream &operator<<(ostream &out, const CompiledMapLoader &obj) {
+    out << "CompiledMapLoader";
+    return out;
+}
+
+/**
+ * Reads the contents of a compiled map file and return the equivalent Map object, which is frozen
+ *
+ * The contents are checked before anything is built from them, and the map is validated as its tables
+ * are read. If the contents can't be read as a map, the returned map is empty.
+ *
+ * @param buffer The contents of the compiled map file
+ * @param name Name of the map
+ * @param errors list the problems found in the map are added to
+ * @return a Map pointer
+ */
+Map *CompiledMapLoader::readMapBuffer(string_view buffer, string name, vector<MapError> &errors) {
+    Map *map = new Map(name);
+    MapChecker checker(errors);
+    if (buffer.size() < sizeof(Header)) {
+        checker.addError(MapError::Type::MALFORMED_FILE, 0, "UNREADABLE COMPILED MAP");
+        return map;
+    }
+
+    Header header{};
+    memcpy(&header, buffer.data(), sizeof(Header));
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+        checker.addError(MapError::Type::MALFORMED_FILE, 0, "UNSUPPORTED COMPILED MAP FORMAT OR VERSION");
+        return map;
+    }
+
+    // Sizes are checked in 64 bits, so corrupted counts can't overflow
+    uint64_t expectedSize = sizeof(Header)
+                            + uint64_t(header.continentCount) * sizeof(ContinentEntry)
+                            + uint64_t(header.territoryCount) * sizeof(TerritoryEntry)
+                            + (uint64_t(header.territoryCount) + 1 + header.adjacencyCount) * sizeof(int32_t)
+                            + header.nameBytes;
+    if (header.fileSize != buffer.size() || expectedSize != buffer.size()) {
+        checker.addError(MapError::Type::MALFORMED_FILE, 0, "TRUNCATED COMPILED MAP");
+        return map;
+    }
+
+    auto *continents = reinterpret_cast<const ContinentEntry *>(buffer.data() + sizeof(Header));
+    auto *territories = reinterpret_cast<const TerritoryEntry *>(continents + header.continentCount);
+    auto *offsets = reinterpret_cast<const int32_t *>(territories + header.territoryCount);
+    const int32_t *ids = offsets + header.territoryCount + 1;
+    const char *names = reinterpret_cast<const char *>(ids + header.adjacencyCount);
+
+    for (uint32_t i = 0; i < header.continentCount; ++i) {
+        const ContinentEntry &continent = continents[i];
+        if (!nameInBlob(continent.nameOffset, continent.nameLength, header.nameBytes)) {
+            checker.addError(MapError::Type::MALFORMED_FILE, 0, "INVALID CONTINENT");
+            return map;
+        }
+        if (!checker.addContinent(string_view(names + continent.nameOffset, continent.nameLength), 0)) {
+            return map;
+        }
+    }
+    for (uint32_t i = 0; i < header.territoryCount; ++i) {
+        const TerritoryEntry &territory = territories[i];
+        if (!nameInBlob(territory.nameOffset, territory.nameLength, header.nameBytes)) {
+            checker.addError(MapError::Type::MALFORMED_FILE, 0, "INVALID COUNTRY/TERRITORY");
+            return map;
+        }
+        if (!checker.addTerritory(string_view(names + territory.nameOffset, territory.nameLength),
+                                  territory.continent, 0)) {
+            return map;
+        }
+    }
+    // Rows must be sorted without duplicates and list every connection both ways, as Map::setAdjacency
+    // expects
+    if (offsets[0] != 0 || uint32_t(offsets[header.territoryCount]) != header.adjacencyCount) {
+        checker.addError(MapError::Type::MALFORMED_FILE, 0, "INVALID BORDERS");
+        return map;
+    }
+    for (uint32_t i = 0; i < header.territoryCount; ++i) {
+        if (offsets[i] > offsets[i + 1]) {
+            checker.addError(MapError::Type::MALFORMED_FILE, 0, "INVALID BORDERS");
+            return map;
+        }
+    }
+    for (uint32_t i = 0; i < header.territoryCount; ++i) {
+        for (int32_t j = offsets[i]; j < offsets[i + 1]; ++j) {
+            if (ids[j] < 0 || uint32_t(ids[j]) >= header.territoryCount
+                || (j > offsets[i] && ids[j] <= ids[j - 1])
+                || !std::binary_search(ids + offsets[ids[j]], ids + offsets[ids[j] + 1], int32_t(i))) {
+                checker.addError(MapError::Type::MALFORMED_FILE, 0, "INVALID BORDERS");
+                return map;
+            }
+            // Each connection is listed in both rows, so only look at it once
+            if (int32_t(i) < ids[j] && !checker.addConnection(i, ids[j])) {
+                return map;
+            }
+        }
+    }
+
+    map->reserve(header.territoryCount, header.continentCount);
+    for (uint32_t i = 0; i < header.continentCount; ++i) {
+        const ContinentEntry &continent = continents[i];
+        map->addContinent(string(names + continent.nameOffset, continent.nameLength), continent.armyValue);
+    }
+    for (uint32_t i = 0; i < header.territoryCount; ++i) {
+        const TerritoryEntry &territory = territories[i];
+        map->addTerritory(string(names + territory.nameOffset, territory.nameLength),
+                          territory.continent, territory.armies);
+    }
+    map->setAdjacency(Span<int>(offsets, offsets + header.territoryCount + 1),
+                      Span<int>(ids, ids + header.adjacencyCount));
+    checker.finish();
+    return map;
+}
+
+/**
+ * Writes a map to a compiled map file, which CompiledMapLoader can read back
+ *
+ * @param map The map to compile. It is frozen if it wasn't already
+ * @param path The path of the compiled map file
+ * @return whether the file was written
+ */
+bool CompiledMapLoader::writeMapFile(Map &map, string path) {
+    map.freeze();
+    const vector<Continent *> &continents = map.getContinents();
+    const vector<Territory *> &territories = map.getTerritories();
+
+    string blob;
+    unordered_map<string, uint32_t> nameOffsets;
+    vector<ContinentEntry> continentTable;
+    for (auto &continent : continents) {
+        uint32_t offset = internName(continent->getName(), blob, nameOffsets);
+        continentTable.push_back({offset, uint32_t(continent->getName().size()), continent->getArmies()});
+    }
+
+    vector<TerritoryEntry> territoryTable;
+    vector<int32_t> offsets{0};
+    vector<int32_t> ids;
+    for (auto &territory : territories) {
+        uint32_t offset = internName(territory->getName(), blob, nameOffsets);
+        territoryTable.push_back({offset, uint32_t(territory->getName().size()),
+                                  territory->getContinent()->getId(), territory->getArmies()});
+        for (int neighborId : map.neighbors(territory->getId())) {
+            ids.push_back(neighborId);
+        }
+        offsets.push_back(ids.size());
+    }
+
+    Header header{};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.continentCount = continentTable.size();
+    header.territoryCount = territoryTable.size();
+    header.adjacencyCount = ids.size();
+    header.nameBytes = blob.size();
+    header.fileSize = sizeof(Header)
+                      + continentTable.size() * sizeof(ContinentEntry)
+                      + territoryTable.size() * sizeof(TerritoryEntry)
+                      + (offsets.size() + ids.size()) * sizeof(int32_t)
+                      + blob.size();
+
+    ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+    out.write(reinterpret_cast<const char *>(continentTable.data()), continentTable.size() * sizeof(ContinentEntry));
+    out.write(reinterpret_cast<const char *>(territoryTable.data()), territoryTable.size() * sizeof(TerritoryEntry));
+    out.write(reinterpret_cast<const char *>(offsets.data()), offsets.size() * sizeof(int32_t));
+    out.write(reinterpret_cast<const char *>(ids.data()), ids.size() * sizeof(int32_t));
+    out.write(blob.data(), blob.size());
+    return out.good();
+}
+
+CompiledMapLoader::~CompiledMapLoader() {}
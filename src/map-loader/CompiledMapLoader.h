@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <iostream>
+
+#include "MapLoader.h"
+
+using std::ostream;
+using std::string;
+
+class Map;
+
+/**
+ * Class for loading compiled map files, written by the compile-map tool, and transforming them to Map
+ * objects.
+ *
+ * A compiled map is a binary snapshot of a loaded map, so loading it needs no parsing: the file is
+ * mapped in memory and its tables are copied into the map as they are. Buffers given to readMapBuffer
+ * must be aligned to 4 bytes, which mapped files and heap buffers are. All values are 32 bits, in the
+ * byte order of the machine which compiled the map:
+ * - header: magic "RWMC", format version, number of continents, territories and adjacency entries,
+ *   size of the name blob and size of the whole file;
+ * - continent table: name offset, name length and army value of each continent;
+ * - territory table: name offset, name length, continent index and armies of each territory;
+ * - adjacency in compressed sparse row form, as built by Map::freeze: territoryCount + 1 offsets, then
+ *   the neighbor ids;
+ * - name blob: every distinct name once, referred to by the tables, without terminators.
+ */
+class CompiledMapLoader : public MapLoader {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    friend ostream &operator<<(ostream &out, const CompiledMapLoader &obj);
+
+    Map *readMapBuffer(string_view buffer, string name, vector<MapError> &errors);
+    static bool writeMapFile(Map &map, string path);
+
+    ~CompiledMapLoader();
+};
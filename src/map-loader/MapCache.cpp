@@ -0,0 +1,148 @@
+#include "MapCache.h"
+
+#include <filesystem>
+#include <functional>
+
+#include "../utils/MappedFile.h"
+
+using std::endl;
+using std::lock_guard;
+using std::make_shared;
+using std::mutex;
+using std::promise;
+
+using cris_utils::MappedFile;
+
+namespace {
+    // Maps kept by the cache shared by the games of the process
+    const int SHARED_CAPACITY = 8;
+}
+
+ostream &operator<<(ostream &out, const MapCacheStats &obj) {
+    out << "MapCacheStats{ "
+        << "hits: " << obj.hits
+        << ", misses: " << obj.misses
+        << ", evictions: " << obj.evictions
+        << ", size: " << obj.size
+        << " }";
+    return out;
+}
+
+/**
+ * @param capacity number of maps kept. At least one is kept
+ */
+MapCache::MapCache(int capacity)
+        : capacity{capacity < 1 ? 1 : capacity},
+          nextId{0},
+          entriesMutex{},
+          entries{},
+          stats{} {}
+
+ostream &operator<<(ostream &out, MapCache &obj) {
+    out << "MapCache{ capacity: " << obj.capacity << ", stats: " << obj.getStats() << " }";
+    return out;
+}
+
+/**
+ * Returns the map stored in a file, loading and validating it if its contents weren't seen yet
+ *
+ * @param path The path to the map file
+ * @param format The format the file is read in
+ * @param errors list the problems found in the map are added to
+ * @return the frozen map, which is shared and must not be modified. Null if the file can't be opened
+ * @throws any exception thrown while reading or validating the map, in every thread waiting for it
+ */
+shared_ptr<const Map> MapCache::load(const string &path, MapFormat format, vector<MapError> &errors) {
+    MappedFile file(path);
+    if (!file.isOpen()) {
+        errors.push_back({MapError::Type::MALFORMED_FILE, 0, "UNREADABLE OR EMPTY FILE"});
+        return nullptr;
+    }
+    string_view contents = file.getText();
+    uint64_t hash = std::hash<string_view>()(contents);
+
+    std::shared_future<shared_ptr<const LoadedMap>> loaded;
+    promise<shared_ptr<const LoadedMap>> loading;
+    bool loader = false;
+    long id = 0;
+    {
+        lock_guard<mutex> lock(entriesMutex);
+        auto found = entries.begin();
+        while (found != entries.end()
+               && (found->hash != hash || found->format != format || found->contents != contents)) {
+            ++found;
+        }
+        if (found != entries.end()) {
+            stats.hits++;
+            entries.splice(entries.begin(), entries, found);
+            loaded = found->loaded;
+        } else {
+            stats.misses++;
+            loader = true;
+            loaded = loading.get_future().share();
+            id = nextId++;
+            entries.push_front({id, hash, string(contents), format, loaded});
+            if (entries.size() > capacity) {
+                entries.pop_back();
+                stats.evictions++;
+            }
+        }
+    }
+
+    // Only the thread which added the entry loads the map, the others wait for it
+    if (loader) {
+        MapLoader *mapLoader = MapLoader::create(format);
+        try {
+            auto result = make_shared<LoadedMap>();
+            shared_ptr<Map> map(mapLoader->readMapBuffer(contents, std::filesystem::path(path).filename(),
+                                                         result->errors));
+            map->freeze();
+            result->map = map;
+            delete mapLoader;
+            loading.set_value(result);
+        } catch (...) {
+            // Not cached, so the next request tries again instead of getting a broken promise
+            delete mapLoader;
+            remove(id);
+            loading.set_exception(std::current_exception());
+            throw;
+        }
+    }
+
+    const LoadedMap &result = *loaded.get();
+    errors.insert(errors.end(), result.errors.begin(), result.errors.end());
+    return result.map;
+}
+
+/**
+ * Removes an entry, if it wasn't evicted already
+ *
+ * @param id
+ */
+void MapCache::remove(long id) {
+    lock_guard<mutex> lock(entriesMutex);
+    entries.remove_if([id](const Entry &entry) { return entry.id == id; });
+}
+
+MapCacheStats MapCache::getStats() {
+    lock_guard<mutex> lock(entriesMutex);
+    MapCacheStats current = stats;
+    current.size = entries.size();
+    return current;
+}
+
+/**
+ * Forgets every cached map. Games keep the maps they already got
+ */
+void MapCache::clear() {
+    lock_guard<mutex> lock(entriesMutex);
+    entries.clear();
+}
+
+/**
+ * Cache shared by the games of the process
+ */
+MapCache &MapCache::shared() {
+    static MapCache cache(SHARED_CAPACITY);
+    return cache;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "MapLoader.h"
+#include "../map/Map.h"
+
+using std::ostream;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+/**
+ * Counters of a MapCache
+ */
+struct MapCacheStats {
+    long hits = 0;
+    long misses = 0;
+    long evictions = 0;
+    // Maps currently cached
+    int size = 0;
+};
+
+ostream &operator<<(ostream &out, const MapCacheStats &obj);
+
+/**
+ * Cache of loaded and validated maps, shared by the games of a process, so games on the same map don't
+ * each parse and validate it.
+ *
+ * Maps are identified by the contents of their file and the format they are read in, not by their
+ * path: the file is hashed on every request, which costs a small fraction of parsing it, so edited
+ * files are loaded again and copies of a file share one entry. Entries keep a copy of the contents,
+ * which is compared on a hash match, so files whose hashes collide are never mistaken for each other. The cached maps are never modified;
+ * games copy them, and the copies share the topology of the cached map (see MapTopology).
+ *
+ * The cache holds a fixed number of maps, and evicts the least recently used one when it is full. It
+ * can be used from several threads: when threads ask for a map which is being loaded, they wait for
+ * that load instead of starting their own. Maps and their errors are cached whether they are valid or
+ * not, since the same contents give the same result. A load which throws isn't cached: the threads
+ * waiting for it get the exception, and the next request loads the file again.
+ *
+ * The cache can't be copied, since it is shared through its mutex.
+ */
+class MapCache {
+private:
+    /**
+     * Outcome of loading a map
+     */
+    struct LoadedMap {
+        shared_ptr<const Map> map;
+        vector<MapError> errors;
+    };
+
+    /**
+     * Cached map, or a map being loaded
+     */
+    struct Entry {
+        // Tells apart entries with the same contents, when a failed load is removed
+        long id;
+        uint64_t hash;
+        string contents;
+        MapFormat format;
+        std::shared_future<shared_ptr<const LoadedMap>> loaded;
+    };
+
+    int capacity;
+    long nextId;
+    // Guards the entries and the counters
+    std::mutex entriesMutex;
+    // Most recently used first
+    std::list<Entry> entries;
+    MapCacheStats stats;
+
+    void remove(long id);
+
+public:
+    explicit MapCache(int capacity);
+    MapCache(const MapCache &other) = delete;
+    MapCache &operator=(const MapCache &other) = delete;
+    friend ostream &operator<<(ostream &out, MapCache &obj);
+
+    shared_ptr<const Map> load(const string &path, MapFormat format, vector<MapError> &errors);
+    MapCacheStats getStats();
+    void clear();
+
+    static MapCache &shared();
+};
+
+ostream &operator<<(ostream &out, MapCache &obj);
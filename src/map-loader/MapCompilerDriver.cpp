@@ -0,0 +1,54 @@
+#include <iostream>
+#include <filesystem>
+
+#include "MapLoader.h"
+#include "CompiledMapLoader.h"
+#include "../map/Map.h"
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+using std::filesystem::path;
+
+/**
+ * Compiles a WarZone or Conquest map file to the binary format read by CompiledMapLoader
+ *
+ * Usage: compile-map <map file> <warzone|conquest> <output file>
+ */
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        cout << "Usage: " << argv[0] << " <map file> <warzone|conquest> <output file>" << endl;
+        return 1;
+    }
+    string mapPath = argv[1];
+    string format = argv[2];
+    string outputPath = argv[3];
+
+    MapLoader *mapLoader;
+    if (format == "conquest") {
+        mapLoader = new ConquestFileReaderAdapter();
+    } else if (format == "warzone") {
+        mapLoader = new MapLoader();
+    } else {
+        cout << "Unknown map format: " << format << endl;
+        return 1;
+    }
+
+    vector<MapError> errors;
+    Map *map = mapLoader->readMapFile(mapPath, path(mapPath).filename(), errors);
+    for (auto &error : errors) {
+        cout << error << endl;
+    }
+    bool compiled = errors.empty() && CompiledMapLoader::writeMapFile(*map, outputPath);
+    if (compiled) {
+        cout << "Compiled " << map->getTerritories().size() << " territories and "
+             << map->getContinents().size() << " continents to " << outputPath << endl;
+    } else {
+        cout << "Couldn't compile " << mapPath << endl;
+    }
+
+    delete mapLoader;
+    delete map;
+    return compiled ? 0 : 1;
+}
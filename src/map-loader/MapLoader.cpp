@@ -1,33 +1,25 @@
 #include "MapLoader.h"
 
-#include <map>
-#include <fstream>
 #include <vector>
 
 #include "../map/Map.h"
 #include "../utils/Utils.h"
+#include "../utils/MappedFile.h"
+#include "CompiledMapLoader.h"
 
-using std::map;
+using std::pair;
 using std::string;
 using std::cout;
 using std::endl;
-using std::ifstream;
+using std::string_view;
 
-using cris_utils::strSplit;
-using cris_utils::trim;
-using cris_utils::isNumber;
+using cris_utils::splitView;
+using cris_utils::trimView;
+using cris_utils::parseInt;
+using cris_utils::MappedFile;
+using cris_utils::nextLine;
 
 namespace {
-    /**
-     * Prints an error message, and the line in the .map file where the error occurred
-     *
-     * @param message
-     * @param lineNum
-     */
-    void printError(string message, int lineNum) {
-        cout << "ERROR: \"" << message << "\" IN MAP FILE AT LINE " << lineNum << endl;
-    }
-
     /**
      * Describes the section of the .map file currently being read
      */
@@ -37,6 +29,15 @@ namespace {
         borders,
         none,
     };
+
+    /**
+     * Border of a Conquest map, kept until every territory is known
+     */
+    struct PendingBorder {
+        int territory;
+        int line;
+        string_view neighbor;
+    };
 }
 
 //=============================
@@ -49,82 +50,123 @@ ostream &operator<<(ostream &out, const MapLoader &obj) {
 }
 
 /**
- * Reads a given WarZone .map file and return the equivalent Map object
+ * Reads a given map file and return the equivalent Map object
+ *
+ * The file is read in place, and parsed by readMapBuffer. Files which can't be opened are empty.
  *
  * @param path The path to the .map file
  * @param name Name of the map
+ * @param errors list the problems found in the map are added to
+ * @return a frozen Map pointer
+ */
+Map *MapLoader::readMapFile(string path, string name, vector<MapError> &errors) {
+    MappedFile mapFile(path);
+    Map *map = readMapBuffer(mapFile.getText(), name, errors);
+    map->freeze();
+    return map;
+}
+
+/**
+ * Parses the contents of a WarZone .map file and return the equivalent Map object
+ *
+ * The map is validated as it is parsed, and parsing stops at the first error. The map isn't frozen, so
+ * building its adjacency can be done separately.
+ *
+ * @param buffer The contents of the .map file
+ * @param name Name of the map
+ * @param errors list the problems found in the map are added to
  * @return a Map pointer
  */
-Map *MapLoader::readMapFile(string path, string name) {
+Map *MapLoader::readMapBuffer(string_view buffer, string name, vector<MapError> &errors) {
     Section currentSection(Section::none);
-    ifstream mapFile(path);
-    string line;
+    string_view text = buffer;
+    string_view line;
 
     Map *map = new Map(name);
+    MapChecker checker(errors);
     int lineNum = 0;
+    // Reused from one line to the next. Tokens are views into the current line
+    vector<string_view> tokens;
 
-    while (getline(mapFile, line)) {
+    while (nextLine(text, line)) {
         lineNum++;
         // Clean line to avoid issues with special characters (line carriage, etc.)
-        trim(line);
+        string_view view = trimView(line);
 
         // Skip empty or comment lines
-        if (line.empty() || line[0] == ';') {
+        if (view.empty() || view[0] == ';') {
             continue;
         }
 
         // If current line is a header for a section, set currentSection accordingly
-        if (line == "[files]") {
+        if (view == "[files]") {
             currentSection = Section::none;
             continue;
-        } else if (line == "[continents]") {
+        } else if (view == "[continents]") {
             currentSection = Section::continents;
             continue;
-        } else if (line == "[countries]") {
+        } else if (view == "[countries]") {
             currentSection = Section::territories;
             continue;
-        } else if (line == "[borders]") {
+        } else if (view == "[borders]") {
             currentSection = Section::borders;
             continue;
         }
 
         switch (currentSection) {
             case Section::continents: {
-                vector<string> tokens = strSplit(line, " ");
+                splitView(view, ' ', tokens);
                 // Expected format of line: "ContinentName ArmyValue"
-                if (tokens.size() < 2 || !isNumber(tokens[1])) {
-                    printError("INVALID CONTINENT", lineNum);
+                int armyValue;
+                if (tokens.size() < 2 || !parseInt(tokens[1], armyValue)) {
+                    checker.addError(MapError::Type::MALFORMED_FILE, lineNum, "INVALID CONTINENT");
+                    return map;
+                }
+                if (!checker.addContinent(tokens[0], lineNum)) {
                     return map;
                 }
-                map->addContinent(tokens[0], stoi(tokens[1]));
+                map->addContinent(string(tokens[0]), armyValue);
                 break;
             }
 
             case Section::territories: {
-                vector<string> tokens = strSplit(line, " ");
+                splitView(view, ' ', tokens);
                 // Expected format of line: "TerritoryId TerritoryName ContinentId"
-                if (tokens.size() < 3 || !isNumber(tokens[0]) || !isNumber(tokens[2])) {
-                    printError("INVALID COUNTRY/TERRITORY", lineNum);
+                int territoryId;
+                int continentId;
+                if (tokens.size() < 3 || !parseInt(tokens[0], territoryId) || !parseInt(tokens[2], continentId)) {
+                    checker.addError(MapError::Type::MALFORMED_FILE, lineNum, "INVALID COUNTRY/TERRITORY");
+                    return map;
+                }
+                // Borders refer to territories by id, so ids must follow the order of the territories
+                if (territoryId != checker.territoryCount() + 1) {
+                    checker.addError(MapError::Type::INVALID_TERRITORY, lineNum,
+                                     "TERRITORY ID " + std::to_string(territoryId) + " OUT OF SEQUENCE");
+                    return map;
+                }
+                if (!checker.addTerritory(tokens[1], continentId - 1, lineNum)) {
                     return map;
                 }
-                int continentIndex = stoi(tokens[2]) - 1;
-                map->addTerritory(tokens[1], continentIndex, 0);
+                map->addTerritory(string(tokens[1]), continentId - 1, 0);
                 break;
             }
             case Section::borders: {
-                vector<string> tokens = strSplit(line, " ");
+                splitView(view, ' ', tokens);
                 // Expected format of line: "TerritoryId Neighbor1 Neighbor2 ..."
-                if (tokens.size() < 2) {
-                    printError("INVALID BORDERS", lineNum);
+                int terr1Id;
+                if (tokens.size() < 2 || !parseInt(tokens[0], terr1Id)) {
+                    checker.addError(MapError::Type::MALFORMED_FILE, lineNum, "INVALID BORDERS");
                     return map;
                 }
-                int terr1Id = stoi(tokens[0]);
                 for (int i = 1; i < tokens.size(); i++) {
-                    if (!isNumber(tokens[i])) {
-                        printError("INVALID BORDERS", lineNum);
+                    int terr2Id;
+                    if (!parseInt(tokens[i], terr2Id)) {
+                        checker.addError(MapError::Type::MALFORMED_FILE, lineNum, "INVALID BORDERS");
+                        return map;
+                    }
+                    if (!checker.addBorder(terr1Id - 1, terr2Id - 1, lineNum)) {
                         return map;
                     }
-                    int terr2Id = stoi(tokens[i]);
                     map->addConnection(terr1Id - 1, terr2Id - 1);
                 }
                 break;
@@ -133,11 +175,69 @@ Map *MapLoader::readMapFile(string path, string name) {
                 break;
         }
     }
+    checker.finish();
     return map;
 }
 
+/**
+ * Guesses the format of a map from its contents: compiled maps start with their magic number, and
+ * the first section header tells Conquest maps from WarZone maps
+ *
+ * @param buffer The contents of the map file
+ * @return the format of the map. WarZone if it can't be told
+ */
+MapFormat MapLoader::detectFormat(string_view buffer) {
+    if (buffer.substr(0, 4) == "RWMC") {
+        return MapFormat::Compiled;
+    }
+    string_view line;
+    while (nextLine(buffer, line)) {
+        string_view view = trimView(line);
+        if (view == "[Map]" || view == "[Continents]" || view == "[Territories]") {
+            return MapFormat::Conquest;
+        }
+        if (view == "[files]" || view == "[continents]" || view == "[countries]" || view == "[borders]") {
+            return MapFormat::WarZone;
+        }
+    }
+    return MapFormat::WarZone;
+}
+
+/**
+ * Creates the loader for a map format
+ *
+ * @param format
+ * @return a new MapLoader, which the caller must delete
+ */
+MapLoader *MapLoader::create(MapFormat format) {
+    switch (format) {
+        case MapFormat::Conquest:
+            return new ConquestFileReaderAdapter();
+        case MapFormat::Compiled:
+            return new CompiledMapLoader();
+        case MapFormat::WarZone:
+        default:
+            return new MapLoader();
+    }
+}
+
 MapLoader::~MapLoader() {}
 
+ostream &operator<<(ostream &out, MapFormat format) {
+    switch (format) {
+        case MapFormat::WarZone:
+            out << "WarZone";
+            break;
+        case MapFormat::Conquest:
+            out << "Conquest";
+            break;
+        case MapFormat::Compiled:
+            out << "Compiled";
+            break;
+    }
+    return out;
+}
+
 ostream &operator<<(ostream &out, const ConquestFileReader &obj) {
     out << "ConquestFileReader";
     return out;
@@ -148,66 +248,96 @@ ostream &operator<<(ostream &out, const ConquestFileReader &obj) {
  *
  * @param path The path to the .map file
  * @param name Name of the map
+ * @param errors list the problems found in the map are added to
+ * @return a frozen Map pointer
+ */
+Map *ConquestFileReader::readConquestFile(string path, string name, vector<MapError> &errors) {
+    // The whole file is scanned in place. Files which can't be opened have no lines
+    MappedFile mapFile(path);
+    Map *map = readConquestBuffer(mapFile.getText(), name, errors);
+    map->freeze();
+    return map;
+}
+
+/**
+ * Parses the contents of a Conquest .map file and return the equivalent Map object
+ *
+ * The map is validated as it is parsed, and parsing stops at the first error. The map isn't frozen, so
+ * building its adjacency can be done separately.
+ *
+ * @param buffer The contents of the .map file
+ * @param name Name of the map
+ * @param errors list the problems found in the map are added to
  * @return a Map pointer
  */
-Map *ConquestFileReader::readConquestFile(string path, string name) {
+Map *ConquestFileReader::readConquestBuffer(string_view buffer, string name, vector<MapError> &errors) {
     Section currentSection(Section::none);
-    ifstream mapFile(path);
-    string line;
+    // Names are kept as views into the buffer
+    string_view text = buffer;
+    string_view line;
 
     Map *newMap = new Map(name);
+    MapChecker checker(errors);
     int lineNum = 0;
-    map<string, int> territories;
-    map<string, int> continents;
-    map<string, vector<string>> connections;
+    // Neighbors are named before they may be defined, so borders are resolved once all territories are known
+    vector<PendingBorder> borders;
+    // Reused from one line to the next. Tokens are views into the current line
+    vector<string_view> tokens;
 
-    while (getline(mapFile, line)) {
+    while (nextLine(text, line)) {
         lineNum++;
         // Clean line to avoid issues with special characters (line carriage, etc.)
-        trim(line);
+        string_view view = trimView(line);
 
         // Skip empty or comment lines
-        if (line.empty() || line[0] == ';') {
+        if (view.empty() || view[0] == ';') {
             continue;
         }
 
         // If current line is a header for a section, set currentSection accordingly
-        if (line == "[Map]") {
+        if (view == "[Map]") {
             currentSection = Section::none;
             continue;
-        } else if (line == "[Continents]") {
+        } else if (view == "[Continents]") {
             currentSection = Section::continents;
             continue;
-        } else if (line == "[Territories]") {
+        } else if (view == "[Territories]") {
             currentSection = Section::territories;
             continue;
         }
 
         switch (currentSection) {
             case Section::continents: {
-                vector<string> tokens = strSplit(line, "=");
+                splitView(view, '=', tokens);
                 // Expected format of line: "ContinentName=ArmyValue"
-                if (tokens.size() < 2 || !isNumber(tokens[1])) {
-                    printError("INVALID CONTINENT", lineNum);
+                int armyValue;
+                if (tokens.size() < 2 || !parseInt(tokens[1], armyValue)) {
+                    checker.addError(MapError::Type::MALFORMED_FILE, lineNum, "INVALID CONTINENT");
                     return newMap;
                 }
-                continents[tokens[0]] = continents.size();
-                newMap->addContinent(tokens[0], stoi(tokens[1]));
+                if (!checker.addContinent(tokens[0], lineNum)) {
+                    return newMap;
+                }
+                newMap->addContinent(string(tokens[0]), armyValue);
                 break;
             }
 
             case Section::territories: {
-                vector<string> tokens = strSplit(line, ",");
+                splitView(view, ',', tokens);
                 // Expected format of line: "TerritoryName,x,y,ContinentName,neighbor1,neighbor2,..."
                 if (tokens.size() < 5) {
-                    printError("INVALID COUNTRY/TERRITORY", lineNum);
+                    checker.addError(MapError::Type::MALFORMED_FILE, lineNum, "INVALID COUNTRY/TERRITORY");
+                    return newMap;
+                }
+                int continentId = checker.findContinent(tokens[3]);
+                if (!checker.addTerritory(tokens[0], continentId, lineNum)) {
                     return newMap;
                 }
-                territories[tokens[0]] = territories.size();
+                int index = newMap->getTerritories().size();
                 for (int i = 4; i < tokens.size(); ++i) {
-                    connections[tokens[0]].push_back(tokens[i]);
+                    borders.push_back({index, lineNum, tokens[i]});
                 }
-                newMap->addTerritory(tokens[0], continents[tokens[3]], 0);
+                newMap->addTerritory(string(tokens[0]), continentId, 0);
                 break;
             }
             case Section::borders:
@@ -215,12 +345,23 @@ Map *ConquestFileReader::readConquestFile(string path, string name) {
                 break;
         }
     }
+
     // Build connections after getting all territories and their indices
-    for (auto &pair : connections) {
-        for (auto &neighbor : pair.second) {
-            newMap->addConnection(territories[pair.first], territories[neighbor]);
+    checker.reserveBorders(borders.size());
+    for (auto &border : borders) {
+        int neighbor = checker.findTerritory(border.neighbor);
+        if (neighbor == -1) {
+            checker.addError(MapError::Type::DANGLING_BORDER, border.line,
+                             "BORDER FROM " + newMap->getTerritories()[border.territory]->getName()
+                             + " TO NON-EXISTENT TERRITORY " + string(border.neighbor));
+            return newMap;
+        }
+        if (!checker.addBorder(border.territory, neighbor, border.line)) {
+            return newMap;
         }
+        newMap->addConnection(border.territory, neighbor);
     }
+    checker.finish();
     return newMap;
 }
 
@@ -232,16 +373,17 @@ ostream &operator<<(ostream &out, const ConquestFileReaderAdapter &obj) {
 }
 
 /**
- * Reads a given Conquest .map file using the MapLoader interface
+ * Parses the contents of a Conquest .map file using the MapLoader interface
  *
  * Delegates map loading to ConquestFileReader
  *
- * @param path The path to the .map file
+ * @param buffer The contents of the .map file
  * @param name Name of the map
+ * @param errors list the problems found in the map are added to
  * @return a Map pointer
  */
-Map *ConquestFileReaderAdapter::readMapFile(string path, string name) {
-    return conquestFileReader->readConquestFile(path, name);
+Map *ConquestFileReaderAdapter::readMapBuffer(string_view buffer, string name, vector<MapError> &errors) {
+    return conquestFileReader->readConquestBuffer(buffer, name, errors);
 }
 
 ConquestFileReaderAdapter::~ConquestFileReaderAdapter() {
@@ -1,21 +1,45 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <iostream>
+#include <vector>
 
 using std::ostream;
 using std::string;
+using std::string_view;
+using std::vector;
 
 class Map;
+struct MapError;
+
+/**
+ * Map file formats which can be loaded
+ */
+enum class MapFormat {
+    WarZone,
+    Conquest,
+    // Binary format written by the compile-map tool
+    Compiled,
+};
+
+ostream &operator<<(ostream &out, MapFormat format);
 
 /**
  * Class for loading WarZone map files and transforming them to Map objects.
+ *
+ * Maps are validated while they are read: the problems found are returned as a list of errors, and a
+ * map is valid if there are none.
  */
 class MapLoader {
 public:
     friend ostream &operator<<(ostream &out, const MapLoader &obj);
 
-    virtual Map *readMapFile(string path, string name);
+    Map *readMapFile(string path, string name, vector<MapError> &errors);
+    virtual Map *readMapBuffer(string_view buffer, string name, vector<MapError> &errors);
+
+    static MapFormat detectFormat(string_view buffer);
+    static MapLoader *create(MapFormat format);
 
     virtual ~MapLoader();
 };
@@ -28,7 +52,8 @@ class ConquestFileReader {
 public:
     friend ostream &operator<<(ostream &out, const ConquestFileReader &obj);
 
-    Map *readConquestFile(string path, string name);
+    Map *readConquestFile(string path, string name, vector<MapError> &errors);
+    Map *readConquestBuffer(string_view buffer, string name, vector<MapError> &errors);
 };
 
 /**
@@ -41,7 +66,7 @@ public:
     ConquestFileReaderAdapter();
     friend ostream &operator<<(ostream &out, const ConquestFileReaderAdapter &obj);
 
-    Map *readMapFile(string path, string name);
+    Map *readMapBuffer(string_view buffer, string name, vector<MapError> &errors);
 
     ~ConquestFileReaderAdapter();
 };
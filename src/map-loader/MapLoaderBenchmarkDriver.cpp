@@ -0,0 +1,317 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "MapLoader.h"
+#include "../map/Map.h"
+#include "../utils/MappedFile.h"
+#include "../utils/NameTable.h"
+#include "../utils/Utils.h"
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::string_view;
+using std::vector;
+
+using cris_utils::MappedFile;
+using cris_utils::NameTable;
+using cris_utils::nextLine;
+using cris_utils::splitView;
+using cris_utils::trimView;
+
+namespace {
+    // Territories in each continent of the generated maps
+    const int CONTINENT_SIZE = 50;
+    // Besides its two neighbors on the ring, each territory borders the territories this far away
+    const int SKIP = 7;
+
+    /**
+     * Returns the neighbors of a territory of the generated maps: the ring of territories with an extra
+     * border in each direction, so every territory has four
+     */
+    vector<int> generatedNeighbors(int id, int territories) {
+        return {(id + territories - 1) % territories, (id + 1) % territories,
+                (id + territories - SKIP) % territories, (id + SKIP) % territories};
+    }
+
+    /**
+     * Writes the text of a WarZone map with the given number of territories, at least 2 * SKIP + 1
+     */
+    string generateWarZoneText(int territories) {
+        string text = "[files]\npic generated_pic.jpg\n\n[continents]\n";
+        int continents = (territories + CONTINENT_SIZE - 1) / CONTINENT_SIZE;
+        for (int i = 0; i < continents; ++i) {
+            text += "Continent_" + std::to_string(i) + " 5 blue\n";
+        }
+        text += "\n[countries]\n";
+        for (int id = 0; id < territories; ++id) {
+            text += std::to_string(id + 1) + " Territory_" + std::to_string(id) + " "
+                    + std::to_string(id / CONTINENT_SIZE + 1) + " " + std::to_string(id % 1000) + " "
+                    + std::to_string(id / 1000) + "\n";
+        }
+        text += "\n[borders]\n";
+        for (int id = 0; id < territories; ++id) {
+            text += std::to_string(id + 1);
+            for (int neighbor : generatedNeighbors(id, territories)) {
+                text += " " + std::to_string(neighbor + 1);
+            }
+            text += "\n";
+        }
+        return text;
+    }
+
+    /**
+     * Writes the text of a Conquest map with the same territories and borders as generateWarZoneText
+     */
+    string generateConquestText(int territories) {
+        string text = "[Map]\nauthor=MapLoaderBenchmark\nwrap=no\n\n[Continents]\n";
+        int continents = (territories + CONTINENT_SIZE - 1) / CONTINENT_SIZE;
+        for (int i = 0; i < continents; ++i) {
+            text += "Continent_" + std::to_string(i) + "=5\n";
+        }
+        text += "\n[Territories]\n";
+        for (int id = 0; id < territories; ++id) {
+            text += "Territory_" + std::to_string(id) + "," + std::to_string(id % 1000) + ","
+                    + std::to_string(id / 1000) + ",Continent_" + std::to_string(id / CONTINENT_SIZE);
+            for (int neighbor : generatedNeighbors(id, territories)) {
+                text += ",Territory_" + std::to_string(neighbor);
+            }
+            text += "\n";
+        }
+        return text;
+    }
+
+    /**
+     * Repeats the continents and territories of a Conquest map, renaming the names of each copy with
+     * the copy's number. The first territory of each copy also borders the first territory of the copies
+     * before and after it, so the copies form a single connected map.
+     */
+    string scaleConquestText(string_view source, int copies) {
+        vector<string_view> continents;
+        vector<string_view> territories;
+        string text;
+        vector<string_view> *section = nullptr;
+        string_view line;
+        while (nextLine(source, line)) {
+            string_view view = trimView(line);
+            if (view == "[Continents]") {
+                section = &continents;
+            } else if (view == "[Territories]") {
+                section = &territories;
+            } else if (section == nullptr) {
+                text += string(view) + "\n";
+            } else if (!view.empty() && view[0] != ';') {
+                section->push_back(view);
+            }
+        }
+
+        vector<string_view> tokens;
+        text += "\n[Continents]\n";
+        for (int copy = 0; copy < copies; ++copy) {
+            string suffix = "_" + std::to_string(copy);
+            for (auto &continent : continents) {
+                splitView(continent, '=', tokens);
+                text += string(tokens[0]) + suffix + "=" + string(tokens[1]) + "\n";
+            }
+        }
+        text += "\n[Territories]\n";
+        for (int copy = 0; copy < copies; ++copy) {
+            string suffix = "_" + std::to_string(copy);
+            for (int i = 0; i < territories.size(); ++i) {
+                splitView(territories[i], ',', tokens);
+                text += string(tokens[0]) + suffix + "," + string(tokens[1]) + "," + string(tokens[2]) + ","
+                        + string(tokens[3]) + suffix;
+                for (int j = 4; j < tokens.size(); ++j) {
+                    text += "," + string(tokens[j]) + suffix;
+                }
+                if (i == 0 && copy > 0) {
+                    text += "," + string(tokens[0]) + "_" + std::to_string(copy - 1);
+                }
+                if (i == 0 && copy < copies - 1) {
+                    text += "," + string(tokens[0]) + "_" + std::to_string(copy + 1);
+                }
+                text += "\n";
+            }
+        }
+        return text;
+    }
+
+    /**
+     * Interns the names of every territory line of a Conquest map: the territory, its continent and its
+     * neighbors. Prints the time taken and the names interned per second
+     */
+    void measureInterning(const string &name, string_view text) {
+        NameTable names;
+        vector<string_view> tokens;
+        string_view line;
+        bool inTerritories = false;
+        long interned = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (nextLine(text, line)) {
+            string_view view = trimView(line);
+            if (view == "[Territories]") {
+                inTerritories = true;
+            } else if (inTerritories && !view.empty()) {
+                splitView(view, ',', tokens);
+                names.intern(tokens[0]);
+                for (int i = 3; i < tokens.size(); ++i) {
+                    names.intern(tokens[i]);
+                }
+                interned += tokens.size() - 2;
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        cout << name << ": interned " << interned << " names (" << names.size() << " distinct) in "
+             << elapsed.count() * 1000 << " ms, " << interned / elapsed.count() / 1e6 << " M names/s" << endl;
+    }
+
+    /**
+     * Loads a map several times, and prints the best time and the throughput
+     *
+     * @param bytes size of the map text
+     * @param load loads the map into a frozen Map, adding its problems to the given errors
+     * @return false if the map has errors, which would stop the loader early
+     */
+    template<typename F>
+    bool measureLoad(const string &name, size_t bytes, int loads, F load) {
+        double best = 0;
+        for (int i = 0; i < loads; ++i) {
+            vector<MapError> errors;
+            auto start = std::chrono::steady_clock::now();
+            Map *map = load(errors);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            int territories = map->getTerritories().size();
+            delete map;
+            if (!errors.empty()) {
+                cout << name << ": " << errors.front() << endl;
+                return false;
+            }
+            if (i == 0 || elapsed.count() < best) {
+                best = elapsed.count();
+            }
+            if (i == loads - 1) {
+                cout << name << " (" << territories << " territories, " << bytes / 1e6 << " MB): " << best
+                     << " s, " << bytes / 1e6 / best << " MB/s" << endl;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Loads a map from memory several times, freezing it like readMapFile does
+     */
+    bool measureBufferLoad(const string &name, MapLoader &loader, string_view text, int loads) {
+        return measureLoad(name, text.size(), loads, [&](vector<MapError> &errors) {
+            Map *map = loader.readMapBuffer(text, name, errors);
+            map->freeze();
+            return map;
+        });
+    }
+
+    /**
+     * Times going through every line of a file and trimming it, and prints the time
+     *
+     * @param scan calls the given function on each line, and returns the number of lines
+     */
+    template<typename F>
+    void measureScan(const string &name, F scan) {
+        size_t characters = 0;
+        auto start = std::chrono::steady_clock::now();
+        long lines = scan([&characters](string_view line) { characters += trimView(line).size(); });
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        cout << name << ": " << elapsed.count() * 1000 << " ms (" << lines << " lines, " << characters
+             << " characters once trimmed)" << endl;
+    }
+}
+
+/**
+ * Benchmark for the map loaders
+ *
+ * Generates WarZone and Conquest maps in memory, where every territory borders four others, and prints
+ * the best time of several loads of each, including freezing the map, and the megabytes parsed per second.
+ *
+ * The Earth Conquest map is then repeated many times, 1000 by default, under new names. The names of its
+ * territory lines are interned into a NameTable, and the repeated map is loaded from memory.
+ *
+ * A larger Conquest map, about 100 MB with the default size, is then written to generated-conquest.map in
+ * the current directory. Its lines are read once through an ifstream and once through the mapped file,
+ * and it is loaded from the file like the game does. The file is removed at the end.
+ *
+ * Usage: MapLoaderBenchmark [territories] [large map territories] [Earth copies] [loads]
+ * The Earth map is read from maps/earth-conquest/Earth.map, from the root of the repository.
+ */
+int main(int argc, char *argv[]) {
+    int territories = argc > 1 ? std::stoi(argv[1]) : 200000;
+    int largeTerritories = argc > 2 ? std::stoi(argv[2]) : 1000000;
+    int earthCopies = argc > 3 ? std::stoi(argv[3]) : 1000;
+    int loads = argc > 4 ? std::stoi(argv[4]) : 3;
+    if (territories <= 2 * SKIP || largeTerritories <= 2 * SKIP || earthCopies <= 0 || loads <= 0) {
+        cout << "Usage: " << argv[0] << " [territories] [large map territories] [Earth copies] [loads]" << endl;
+        return 1;
+    }
+
+    MapLoader warZoneLoader;
+    ConquestFileReaderAdapter conquestLoader;
+    if (!measureBufferLoad("WarZone", warZoneLoader, generateWarZoneText(territories), loads)
+        || !measureBufferLoad("Conquest", conquestLoader, generateConquestText(territories), loads)) {
+        return 1;
+    }
+
+    const string earthPath = "maps/earth-conquest/Earth.map";
+    MappedFile earth(earthPath);
+    if (!earth.isOpen()) {
+        cout << "Can't open " << earthPath << endl;
+        return 1;
+    }
+    string scaledEarth = scaleConquestText(earth.getText(), earthCopies);
+    string scaledName = "Earth x" + std::to_string(earthCopies);
+    measureInterning(scaledName, scaledEarth);
+    if (!measureBufferLoad(scaledName, conquestLoader, scaledEarth, loads)) {
+        return 1;
+    }
+
+    const string path = "generated-conquest.map";
+    size_t bytes;
+    {
+        string text = generateConquestText(largeTerritories);
+        bytes = text.size();
+        std::ofstream file(path, std::ios::binary);
+        file << text;
+        if (!file) {
+            cout << "Can't write " << path << endl;
+            return 1;
+        }
+    }
+
+    measureScan("Lines read with ifstream and getline", [&path](auto onLine) {
+        std::ifstream file(path);
+        string line;
+        long lines = 0;
+        while (std::getline(file, line)) {
+            onLine(line);
+            lines++;
+        }
+        return lines;
+    });
+    measureScan("Lines read with MappedFile and nextLine", [&path](auto onLine) {
+        MappedFile file(path);
+        string_view text = file.getText();
+        string_view line;
+        long lines = 0;
+        while (nextLine(text, line)) {
+            onLine(line);
+            lines++;
+        }
+        return lines;
+    });
+
+    ConquestFileReader reader;
+    bool valid = measureLoad("Conquest file", bytes, loads, [&reader, &path](vector<MapError> &errors) {
+        return reader.readConquestFile(path, "Generated", errors);
+    });
+    std::remove(path.c_str());
+    return valid ? 0 : 1;
+}
@@ -1,11 +1,14 @@
 #include <iostream>
 #include "MapLoader.h"
+#include "CompiledMapLoader.h"
 #include "../map/Map.h"
 
 using std::cout;
 using std::endl;
+using std::string;
+using std::vector;
 
-void evaluateMap(Map &map);
+Map *evaluateMap(MapLoader *mapLoader, string path, string name);
 
 /**
  * Driver for MapLoader
@@ -15,38 +18,51 @@ int main() {
     MapLoader *mapLoader = new MapLoader();
 
     // Valid
-    Map *zertina = mapLoader->readMapFile("zertina.map", "Zertina");
-    evaluateMap(*zertina);
+    Map *zertina = evaluateMap(mapLoader, "zertina.map", "Zertina");
 
     // Valid
-    Map *canada = mapLoader->readMapFile("canada.map", "Canada");
-    evaluateMap(*canada);
+    Map *canada = evaluateMap(mapLoader, "canada.map", "Canada");
 
     // Valid
-    Map *usa = mapLoader->readMapFile("usa8regions.map", "USA");
-    evaluateMap(*usa);
+    Map *usa = evaluateMap(mapLoader, "usa8regions.map", "USA");
 
     // Invalid
-    Map *invalid = mapLoader->readMapFile("invalid.map", "Invalid");
-    evaluateMap(*invalid);
+    Map *invalid = evaluateMap(mapLoader, "invalid.map", "Invalid");
 
     MapLoader *conquestMapLoader = new ConquestFileReaderAdapter();
 
-    Map *conquestMap = conquestMapLoader->readMapFile("Earth.map", "Earth");
-    evaluateMap(*conquestMap);
+    Map *conquestMap = evaluateMap(conquestMapLoader, "Earth.map", "Earth");
+
+    // Compiled from the Conquest map, and read back without parsing
+    CompiledMapLoader::writeMapFile(*conquestMap, "Earth.cmap");
+    MapLoader *compiledMapLoader = new CompiledMapLoader();
+
+    Map *compiledMap = evaluateMap(compiledMapLoader, "Earth.cmap", "Earth");
 
     delete mapLoader;
     delete conquestMapLoader;
+    delete compiledMapLoader;
 
     delete zertina;
     delete canada;
     delete usa;
     delete invalid;
     delete conquestMap;
+    delete compiledMap;
 }
 
-void evaluateMap(Map &map) {
-    cout << map;
-    bool valid = map.validate();
-    cout << "Valid: " << valid << endl << endl << endl;
+/**
+ * Loads a map, prints it and whether it is valid
+ *
+ * @return the map
+ */
+Map *evaluateMap(MapLoader *mapLoader, string path, string name) {
+    vector<MapError> errors;
+    Map *map = mapLoader->readMapFile(path, name, errors);
+    cout << *map;
+    for (auto &error : errors) {
+        cout << error << endl;
+    }
+    cout << "Valid: " << errors.empty() << endl << endl << endl;
+    return map;
 }
@@ -0,0 +1,153 @@
+#include "MapPipeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+
+#include "../map/Map.h"
+#include "../utils/MappedFile.h"
+#include "../utils/ThreadPool.h"
+
+using std::endl;
+using std::filesystem::recursive_directory_iterator;
+
+using cris_utils::MappedFile;
+using cris_utils::ThreadPool;
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    // Bytes between the reads which bring a mapped file into memory
+    const size_t PAGE_SIZE = 4096;
+
+    double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+}
+
+ostream &operator<<(ostream &out, const MapStageTimes &obj) {
+    out << "MapStageTimes{ "
+        << "io: " << obj.io
+        << ", parse: " << obj.parse
+        << ", build: " << obj.build
+        << " }";
+    return out;
+}
+
+ostream &operator<<(ostream &out, const MapReport &obj) {
+    out << "MapReport{ "
+        << "path: " << obj.path
+        << ", format: " << obj.format
+        << ", readable: " << obj.readable
+        << ", valid: " << obj.valid
+        << ", territories: " << obj.territories
+        << ", continents: " << obj.continents
+        << ", connections: " << obj.connections
+        << ", times: " << obj.times
+        << ", errors[" << obj.errors.size() << "]: [" << endl;
+    for (auto &error : obj.errors) {
+        out << "\t" << error << endl;
+    }
+    out << "] }";
+    return out;
+}
+
+/**
+ * Finds every map file under a directory, WarZone and Conquest .map files as well as compiled .cmap
+ * files
+ *
+ * @param directory
+ * @return paths of the map files, sorted
+ */
+vector<string> findMapFiles(const string &directory) {
+    vector<string> maps{};
+    for (auto &item : recursive_directory_iterator(directory)) {
+        string extension = item.path().extension().string();
+        if (!item.is_directory() && (extension == ".map" || extension == ".cmap")) {
+            maps.push_back(item.path().string());
+        }
+    }
+    std::sort(maps.begin(), maps.end());
+    return maps;
+}
+
+/**
+ * Loads a map file with the loader matching its format, validates it, and reports how it went
+ *
+ * The map is validated while it is parsed. Errors are collected in the report instead of being
+ * printed, so maps can be loaded concurrently.
+ *
+ * @param path
+ * @return the report of the map
+ */
+MapReport loadAndValidateMap(const string &path) {
+    MapReport report;
+    report.path = path;
+
+    auto start = Clock::now();
+    MappedFile file(path);
+    // Touch every page, so reading the file counts as I/O rather than as parsing
+    volatile char sink = 0;
+    for (size_t offset = 0; offset < file.getSize(); offset += PAGE_SIZE) {
+        sink = sink + file.getData()[offset];
+    }
+    report.times.io = secondsSince(start);
+    if (!file.isOpen()) {
+        report.errors.push_back({MapError::Type::MALFORMED_FILE, 0, "UNREADABLE OR EMPTY FILE"});
+        return report;
+    }
+    report.readable = true;
+
+    start = Clock::now();
+    report.format = MapLoader::detectFormat(file.getText());
+    MapLoader *loader = MapLoader::create(report.format);
+    Map *map = loader->readMapBuffer(file.getText(), std::filesystem::path(path).filename(), report.errors);
+    report.valid = report.errors.empty();
+    report.times.parse = secondsSince(start);
+
+    start = Clock::now();
+    map->freeze();
+    report.times.build = secondsSince(start);
+
+    report.territories = map->getTerritories().size();
+    report.continents = map->getContinents().size();
+    for (auto &territory : map->getTerritories()) {
+        report.connections += map->neighbors(territory->getId()).size();
+    }
+    report.connections /= 2;
+
+    delete map;
+    delete loader;
+    return report;
+}
+
+/**
+ * Loads and validates map files concurrently
+ *
+ * Each map is a task of a work-stealing pool. The largest files are submitted first, so a few big
+ * maps don't end up alone at the end of the batch.
+ *
+ * @param paths map files
+ * @param numThreads threads loading maps. Every core is used when 0
+ * @return the report of each map, in the order of the paths
+ */
+vector<MapReport> loadAndValidateMaps(const vector<string> &paths, int numThreads) {
+    vector<MapReport> reports(paths.size());
+    vector<std::uintmax_t> sizes(paths.size(), 0);
+    vector<int> order(paths.size());
+    for (int i = 0; i < paths.size(); ++i) {
+        order[i] = i;
+        std::error_code error;
+        sizes[i] = std::filesystem::file_size(paths[i], error);
+    }
+    std::stable_sort(order.begin(), order.end(), [&sizes](int i, int j) {
+        return sizes[i] > sizes[j];
+    });
+
+    ThreadPool pool(numThreads > 0 ? numThreads : cris_utils::hardwareThreads());
+    for (int i : order) {
+        pool.submit([&reports, &paths, i] { reports[i] = loadAndValidateMap(paths[i]); });
+    }
+    pool.wait();
+    return reports;
+}
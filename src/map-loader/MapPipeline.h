@@ -0,0 +1,49 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "MapLoader.h"
+#include "../map/Map.h"
+
+using std::ostream;
+using std::string;
+using std::vector;
+
+/**
+ * Time spent on each stage of loading and validating a map, in seconds
+ */
+struct MapStageTimes {
+    // Mapping the file and reading it into memory
+    double io = 0;
+    // Parsing the file into territories, continents and connections, validating them on the way
+    double parse = 0;
+    // Building the adjacency arrays
+    double build = 0;
+};
+
+ostream &operator<<(ostream &out, const MapStageTimes &obj);
+
+/**
+ * Outcome of loading and validating one map file
+ */
+struct MapReport {
+    string path;
+    // Format detected from the contents of the file
+    MapFormat format = MapFormat::WarZone;
+    bool readable = false;
+    bool valid = false;
+    int territories = 0;
+    int continents = 0;
+    int connections = 0;
+    // Problems found while loading the map
+    vector<MapError> errors;
+    MapStageTimes times;
+};
+
+ostream &operator<<(ostream &out, const MapReport &obj);
+
+vector<string> findMapFiles(const string &directory);
+MapReport loadAndValidateMap(const string &path);
+vector<MapReport> loadAndValidateMaps(const vector<string> &paths, int numThreads);
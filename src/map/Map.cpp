@@ -5,64 +5,58 @@
 
 #include "../utils/Utils.h"
 #include "../player/Player.h"
+#include "../MoveLog.h"
 
 using std::cout;
 using std::endl;
 using std::runtime_error;
 using std::find;
 using std::pair;
-using std::set_difference;
-using std::inserter;
+using std::sort;
+using std::lower_bound;
 
-using cris_utils::contains;
-using cris_utils::compare;
-using cris_utils::contains;
-using cris_utils::vectorToSet;
+using cris_utils::Span;
+using cris_utils::Bitset;
 
 namespace {
 
     /**
-     * Perform Depth-first-search on a graph.
+     * Finds the representative of a territory in a union-find forest, halving paths along the way.
      *
-     * Keeps track of which vertices were encountered by using the "found" bool flags.
-     *
-     * @param current Current territory
-     * @param adj
-     * @param found set of bool flag for each territory on the map.
+     * @param parent parent of each territory id in the forest
+     * @param id
+     * @return id of the root of the territory's tree
      */
-    void dfs(Territory *current,
-             map<Territory *, set<Territory *>> &adj,
-             set<Territory *> &found) {
-        found.insert(current);
-        for (auto territory : adj[current]) {
-            if (!contains(found, territory)) {
-                dfs(territory, adj, found);
-            }
+    int findRoot(vector<int> &parent, int id) {
+        while (parent[id] != id) {
+            parent[id] = parent[parent[id]];
+            id = parent[id];
         }
+        return id;
     }
 
     /**
-     * Performs Depth-first-search of a continent subgraph.
+     * Merges the trees of two territories in a union-find forest.
      *
-     * Keeps track of which vertices were encountered and stores them in the "found" vector
-     * @param current
-     * @param continent
-     * @param territories
-     * @param adj
-     * @param found
+     * @param parent parent of each territory id in the forest
+     * @param t1
+     * @param t2
+     * @return whether the territories were in different trees
      */
-    void dfsContinent(Territory *current,
-                      Continent *continent,
-                      set<Territory *> continentTerritories,
-                      map<Territory *, set<Territory *>> &adj,
-                      set<Territory *> &found) {
-        found.insert(current);
-        for (auto territory : adj[current]) {
-            if (!contains(found, territory) && contains(continentTerritories, territory)) {
-                dfsContinent(territory, continent, continentTerritories, adj, found);
-            }
+    bool unite(vector<int> &parent, int t1, int t2) {
+        int root1 = findRoot(parent, t1);
+        int root2 = findRoot(parent, t2);
+        // Keep the smallest id as the root, so components are reported in map order
+        if (root1 < root2) {
+            parent[root2] = root1;
+        } else if (root2 < root1) {
+            parent[root1] = root2;
         }
+        return root1 != root2;
     }
+
+    // Asymmetric borders described one by one, before the rest are only counted
+    const int MAX_REPORTED_BORDERS = 10;
 }
 
 //=============================
@@ -71,20 +65,32 @@ namespace {
 
 Map::Map(string name)
         : name{name},
+          topology{std::make_shared<MapTopology>()},
+          store{new TerritoryStore(topology.get())},
+          territoryHandles{},
           territories{},
-          continents{} {}
+          continentTerritories{},
+          adjTerritories{} {}
 
+// Like before territories were stored together, copied territories don't keep their owner. The
+// topology is shared with the other map, so only the state of the territories is copied
 Map::Map(const Map &other)
         : name{other.name},
+          topology{other.topology},
+          store{new TerritoryStore(*other.store)},
+          territoryHandles{},
           territories{},
-          continents{} {
-    for (auto territory : other.territories) {
-        territories.push_back(new Territory(*territory));
-    }
-
-    for (auto continent : other.continents) {
-        continents.push_back(new Continent(*continent));
+          continentTerritories(topology->continents.size()),
+          adjTerritories{} {
+    // Changes to the copy aren't part of the original's log
+    store->clearOwners();
+    store->setMoveLog(nullptr);
+
+    territories.reserve(store->size());
+    for (int i = 0; i < store->size(); ++i) {
+        addHandle(i);
     }
+    bindAdjacency();
 }
 
 /**
@@ -97,8 +103,12 @@ void swap(Map &a, Map &b) {
     using std::swap;
 
     swap(a.name, b.name);
+    swap(a.topology, b.topology);
+    swap(a.store, b.store);
+    swap(a.territoryHandles, b.territoryHandles);
     swap(a.territories, b.territories);
-    swap(a.continents, b.continents);
+    swap(a.continentTerritories, b.continentTerritories);
+    swap(a.adjTerritories, b.adjTerritories);
 }
 
 Map &Map::operator=(Map other) {
@@ -109,9 +119,9 @@ Map &Map::operator=(Map other) {
 ostream &operator<<(ostream &out, const Map &obj) {
     out << "Map{" << endl
         << "name: " << obj.name << endl
-        << "continents[" << obj.continents.size() << "][" << endl;
+        << "continents[" << obj.getContinents().size() << "][" << endl;
 
-    for (const auto &continent : obj.continents) {
+    for (const auto &continent : obj.getContinents()) {
         out << "\t" << *continent << endl;
     }
 
@@ -122,12 +132,14 @@ ostream &operator<<(ostream &out, const Map &obj) {
     }
 
     out << "adj{" << endl;
-    for (auto &pair : obj.adj) {
-        out << "\t" << pair.first->getName() << ": { ";
-        for (Territory *adjTerritory : pair.second) {
-            out << adjTerritory->getName() << " ";
+    if (obj.topology->isFrozen()) {
+        for (auto &territory : obj.territories) {
+            out << "\t" << territory->getName() << ": { ";
+            for (int neighborId : obj.neighbors(territory->getId())) {
+                out << obj.territories[neighborId]->getName() << " ";
+            }
+            out << "}" << endl;
         }
-        out << "}" << endl;
     }
 
     out << "}" << endl << "}" << endl;
@@ -135,7 +147,50 @@ ostream &operator<<(ostream &out, const Map &obj) {
 }
 
 /**
- * Add territory to map
+ * Returns the topology to modify, copying it first if other maps share it
+ */
+MapTopology &Map::editTopology() {
+    if (topology.use_count() > 1) {
+        topology = std::make_shared<MapTopology>(*topology);
+        store->setTopology(topology.get());
+    }
+    return *topology;
+}
+
+/**
+ * Creates the handle of a territory of the store, and lists it with the territories of its continent
+ *
+ * @param id
+ */
+void Map::addHandle(int id) {
+    Territory *handle = &territoryHandles.emplace_back(store, id);
+    territories.push_back(handle);
+
+    Continent *continent = topology->territoryContinents[id];
+    int continentId = continent->getId();
+    if (continentId >= 0 && continentId < topology->continents.size()
+        && topology->continents[continentId] == continent) {
+        continentTerritories[continentId].push_back(handle);
+    }
+}
+
+/**
+ * Points the neighbors of each territory to this map's handles, if the topology is frozen
+ */
+void Map::bindAdjacency() {
+    if (!topology->frozen) {
+        adjTerritories.clear();
+        return;
+    }
+    const vector<int> &adjIds = topology->adjIds;
+    adjTerritories.resize(adjIds.size());
+    for (int i = 0; i < adjIds.size(); ++i) {
+        adjTerritories[i] = territories[adjIds[i]];
+    }
+}
+
+/**
+ * Add territory to map. Territories of continents which don't exist are ignored
  * @param name name of territory
  * @param continent index of the continent
  * @param armies number of armies
@@ -144,11 +199,18 @@ void Map::addTerritory(
         string name,
         int continent,
         int armies) {
-    auto *newTerritory = new Territory(name, continents[continent], armies);
-    territories.push_back(newTerritory);
-    if (contains(adj, newTerritory)) {
-        adj.insert(pair<Territory *, set<Territory *>>(newTerritory, set<Territory *>{}));
+    if (continent < 0 || continent >= topology->continents.size()) {
+        cout << "INVALID CONTINENT: " << continent << " OF TERRITORY " << name << endl;
+        return;
     }
+    MapTopology &editable = editTopology();
+    int id = store->add(armies);
+    editable.names.push_back(name);
+    editable.territoryContinents.push_back(editable.continents[continent]);
+    editable.continentTerritories[continent].push_back(id);
+    editable.continentMasks[continent].set(id);
+    editable.frozen = false;
+    addHandle(id);
 }
 
 /**
@@ -159,8 +221,11 @@ void Map::addTerritory(
 void Map::addContinent(
         string name,
         int armyValue) {
-    auto *newContinent = new Continent(name, armyValue);
-    continents.push_back(newContinent);
+    MapTopology &editable = editTopology();
+    editable.continents.push_back(new Continent(editable.continents.size(), name, armyValue));
+    editable.continentTerritories.emplace_back();
+    editable.continentMasks.emplace_back();
+    continentTerritories.emplace_back();
 }
 
 /**
@@ -169,9 +234,10 @@ void Map::addContinent(
  * @param t2 The index of the second territory
  */
 void Map::addConnection(int t1, int t2) {
-    if (t1 < territories.size() && t2 < territories.size()) {
-        adj[territories[t1]].insert(territories[t2]);
-        adj[territories[t2]].insert(territories[t1]);
+    if (t1 >= 0 && t2 >= 0 && t1 < territories.size() && t2 < territories.size()) {
+        MapTopology &editable = editTopology();
+        editable.connections.emplace_back(t1, t2);
+        editable.frozen = false;
     } else {
         cout << "INVALID CONNECTION: ( " << t1 << ", " << t2 << " )" << endl;
     }
@@ -179,87 +245,213 @@ void Map::addConnection(int t1, int t2) {
 }
 
 /**
- * Validates the current map
- * @return Whether the map is valid or not
+ * Reserves room for a number of territories and continents, for loaders which know them in advance
+ *
+ * @param territoryCount
+ * @param continentCount
  */
-bool Map::validate() {
-    // Validate that map contains territories anc continents.
-    if (continents.empty()) {
-        cout << "INVALID MAP: EMPTY CONTINENT LIST" << endl;
-        return false;
+void Map::reserve(int territoryCount, int continentCount) {
+    MapTopology &editable = editTopology();
+    editable.names.reserve(territoryCount);
+    editable.territoryContinents.reserve(territoryCount);
+    editable.continents.reserve(continentCount);
+    editable.continentTerritories.reserve(continentCount);
+    editable.continentMasks.reserve(continentCount);
+    store->reserve(territoryCount);
+    territories.reserve(territoryCount);
+    continentTerritories.reserve(continentCount);
+}
+
+/**
+ * Builds the compressed sparse row adjacency arrays from the connections added so far.
+ *
+ * Called once loading is done. Adding territories or connections afterwards un-freezes the map, and
+ * the arrays are rebuilt on the next call. Does nothing if the map is already frozen, so maps sharing a
+ * frozen topology can call it from several threads.
+ */
+void Map::freeze() {
+    if (topology->frozen) {
+        return;
+    }
+    MapTopology &editable = editTopology();
+    int numTerritories = territories.size();
+
+    // Count the connections of each territory, then turn the counts into row offsets
+    vector<int> offsets(numTerritories + 1, 0);
+    for (auto &connection : editable.connections) {
+        offsets[connection.first + 1]++;
+        offsets[connection.second + 1]++;
+    }
+    for (int i = 0; i < numTerritories; ++i) {
+        offsets[i + 1] += offsets[i];
     }
 
-    if (territories.empty()) {
-        cout << "INVALID MAP: EMPTY TERRITORY LIST" << endl;
-        return false;
+    vector<int> ids(offsets[numTerritories]);
+    vector<int> cursor(offsets.begin(), offsets.end() - 1);
+    for (auto &connection : editable.connections) {
+        ids[cursor[connection.first]++] = connection.second;
+        ids[cursor[connection.second]++] = connection.first;
     }
 
-    // Validate map is a connected graph
-    {
-        set<Territory *> found{};
-        set<Territory *> territoriesSet = vectorToSet(territories);
-        dfs(*territories.begin(), adj, found);
-        if (!compare(found, territoriesSet)) {
-            cout << "INVALID MAP: NOT A CONNECTED GRAPH. THESE TERRITORIES WEREN'T FOUND DURING THE DFS SEARCH: ( ";
-            for (auto &territory : territories) {
-                if (!contains(found, territory)) {
-                    cout << territory->getName() << " ";
-                }
+    // Sort each row and drop duplicate connections (map files usually list each border twice)
+    vector<int> &adjOffsets = editable.adjOffsets;
+    vector<int> &adjIds = editable.adjIds;
+    adjOffsets.assign(numTerritories + 1, 0);
+    adjIds.clear();
+    adjIds.reserve(ids.size());
+    for (int i = 0; i < numTerritories; ++i) {
+        sort(ids.begin() + offsets[i], ids.begin() + offsets[i + 1]);
+        for (int j = offsets[i]; j < offsets[i + 1]; ++j) {
+            if (j == offsets[i] || ids[j] != ids[j - 1]) {
+                adjIds.push_back(ids[j]);
             }
-            cout << ")" << endl;
-            return false;
         }
+        adjOffsets[i + 1] = adjIds.size();
     }
 
+    editable.frozen = true;
+    bindAdjacency();
+}
+
+/**
+ * Sets the adjacency arrays directly, for loaders which already have them in the form built by freeze:
+ * each row sorted by id, without duplicates, and every connection listed in the rows of both
+ * territories. The map is frozen afterwards.
+ *
+ * The connections are kept as well, so the map can still be copied and extended.
+ *
+ * @param offsets territoryCount + 1 row offsets into ids
+ * @param ids neighbor ids
+ */
+void Map::setAdjacency(Span<int> offsets, Span<int> ids) {
+    MapTopology &editable = editTopology();
+    int numTerritories = territories.size();
+    editable.adjOffsets.assign(offsets.begin(), offsets.end());
+    editable.adjIds.assign(ids.begin(), ids.end());
+
+    editable.connections.clear();
+    editable.connections.reserve(ids.size() / 2);
+    for (int i = 0; i < numTerritories; ++i) {
+        for (int j = offsets[i]; j < offsets[i + 1]; ++j) {
+            if (i < ids[j]) {
+                editable.connections.emplace_back(i, ids[j]);
+            }
+        }
+    }
+    editable.frozen = true;
+    bindAdjacency();
+}
+
+/**
+ * Moves a territory to another continent, which may not be part of the map. The territory is still
+ * listed with the territories of its former continent
+ *
+ * @param territory
+ * @param continent
+ */
+void Map::setContinent(Territory *territory, Continent *continent) {
+    editTopology().territoryContinents[territory->getId()] = continent;
+}
+
+/**
+ * Validates the current map
+ * @return Whether the map is valid or not
+ */
+bool Map::validate() {
+    return validate(cout);
+}
+
+/**
+ * Validates the current map, describing the problems found to a given stream
+ *
+ * The map is checked the way loaders check it while reading a file, see MapChecker.
+ *
+ * @param out
+ * @return Whether the map is valid or not
+ */
+bool Map::validate(ostream &out) {
+    const vector<Continent *> &continents = topology->continents;
+    const vector<pair<int, int>> &connections = topology->connections;
+
     // Validate each country belongs to one and only one continent.
     for (const auto &territory : territories) {
-        if (!contains(continents, territory->getContinent())) {
-            cout << "INVALID MAP: " << *territory << " HAS A NON-EXISTENT CONTINENT: "
+        int continentId = territory->getContinent()->getId();
+        if (continentId < 0 || continentId >= continents.size()
+            || continents[continentId] != territory->getContinent()) {
+            out << "INVALID MAP: " << *territory << " HAS A NON-EXISTENT CONTINENT: "
                  << territory->getContinent()->getName()
                  << endl;
             return false;
         }
     }
 
-    // Validate continents are connected sub-graphs
-    for (auto &continent : continents) {
-        set<Territory *> continentTerritories = getTerritoriesByContinent(continent);
-        set<Territory *> found{};
-        dfsContinent(*continentTerritories.begin(), continent, continentTerritories, adj, found);
-        if (!compare(continentTerritories, found)) {
-            cout << "INVALID MAP: THE FOLLOWING TERRITORIES OF " << *continent << " AREN'T CONNECTED: ( ";
-            for (auto continentTerritory : continentTerritories) {
-                if (!contains(found, continentTerritory)) {
-                    cout << continentTerritory->getName() << " ";
-                }
-            }
-            cout << ")" << endl;
-            return false;
-        }
+    vector<MapError> errors;
+    MapChecker checker(errors);
+    bool valid = true;
+    for (int i = 0; valid && i < continents.size(); ++i) {
+        valid = checker.addContinent(continents[i]->getName(), 0);
+    }
+    for (int i = 0; valid && i < territories.size(); ++i) {
+        valid = checker.addTerritory(territories[i]->getName(), territories[i]->getContinent()->getId(), 0);
     }
+    for (int i = 0; valid && i < connections.size(); ++i) {
+        valid = checker.addConnection(connections[i].first, connections[i].second);
+    }
+    valid = valid && checker.finish();
 
-    return true;
+    for (auto &error : errors) {
+        out << error << endl;
+    }
+    return valid;
+}
+
+/**
+ * Returns the state of all territories, for scanning the whole map without going through each territory
+ */
+const TerritoryStore &Map::getTerritoryStore() const {
+    return *store;
+}
+
+/**
+ * Returns the names, continents and borders of the map, which can be shared with other threads. The
+ * topology is only complete once the map is frozen
+ */
+shared_ptr<const MapTopology> Map::getTopology() const {
+    return topology;
+}
+
+/**
+ * Records the changes to the territories in a log, or stops recording them when null
+ *
+ * @param moveLog
+ * @see MoveLog
+ */
+void Map::setMoveLog(MoveLog *moveLog) {
+    store->setMoveLog(moveLog);
 }
 
 const vector<Territory *> &Map::getTerritories() const {
     return territories;
 }
 
+const vector<Continent *> &Map::getContinents() const {
+    return topology->continents;
+}
+
 /**
    * Returns all territories that belong to a given continent
    *
    * @param continent
-   * @return list of territories which are part of continent
+   * @return a view over the territories which are part of continent, valid until a territory is added.
+   * Empty if the continent isn't part of the map
    */
-const set<Territory *> Map::getTerritoriesByContinent(Continent *continent) const {
-    set<Territory *> contTerritories{};
-
-    for (Territory *territory : territories) {
-        if (territory->getContinent() == continent) {
-            contTerritories.insert(territory);
-        }
+Span<Territory *> Map::getTerritoriesByContinent(Continent *continent) const {
+    int id = continent->getId();
+    if (id < 0 || id >= continentTerritories.size() || topology->continents[id] != continent) {
+        return Span<Territory *>();
     }
-    return contTerritories;
+    const vector<Territory *> &contTerritories = continentTerritories[id];
+    return Span<Territory *>(contTerritories.data(), contTerritories.data() + contTerritories.size());
 }
 
 /**
@@ -270,62 +462,111 @@ const set<Territory *> Map::getTerritoriesByContinent(Continent *continent) cons
  * @return Whether the two territories are adjacent
  */
 bool Map::areAdjacent(Territory *t1, Territory *t2) {
-    return adj[t1].find(t2) != adj[t1].end();
+    freeze();
+    return areAdjacent(t1->getId(), t2->getId());
+}
+
+/**
+ * Returns whether two territories are adjacent, by id. The map must be frozen.
+ *
+ * @param t1 The id of the first territory
+ * @param t2 The id of the second territory
+ * @return Whether the two territories are adjacent
+ */
+bool Map::areAdjacent(int t1, int t2) const {
+    return topology->areAdjacent(t1, t2);
 }
 
 /**
  * Returns the set of continents which are currently controlled by a given player
  *
+ * Compares the per-continent territory counts the player keeps up to date as it captures and loses
+ * territories against the size of each continent, so this doesn't look at any territory.
+ *
  * @param player
  * @return the set of continents which are currently controlled by a given player
  */
 set<Continent *> Map::getContinentsControlledByPlayer(Player *player) {
+    const vector<Continent *> &continents = topology->continents;
     set<Continent *> controlledContinents{};
-    for (auto &continent : continents) {
-        set<Territory *> cTerrs = getTerritoriesByContinent(continent);
-        set<Territory *> difference;
-        set_difference(cTerrs.begin(), cTerrs.end(),
-                       player->getOwnedTerritories().begin(), player->getOwnedTerritories().end(),
-                       inserter(difference, difference.end()));
-        if (difference.empty()) {
-            controlledContinents.insert(continent);
+    for (int i = 0; i < continents.size(); ++i) {
+        if (player->getTerritoryCount(continents[i]) == continentTerritories[i].size()) {
+            controlledContinents.insert(continents[i]);
         }
     }
     return controlledContinents;
 }
 
 /**
- * Returns the neighbors of a given territory
+ * Returns the ids of the territories which belong to a given continent
+ *
+ * @param continent
+ * @return the territory ids of the continent
+ */
+const Bitset &Map::getContinentMask(Continent *continent) const {
+    return topology->getContinentMask(continent->getId());
+}
+
+/**
+ * Returns the neighbors of a given territory, sorted by id
  *
  * @param territory
- * @return the neighbors of a given territory
+ * @return a view over the neighbors of a given territory, valid until the map is modified
  */
-const set<Territory *> Map::getNeighbors(Territory *territory) {
-    return adj[territory];
+Span<Territory *> Map::getNeighbors(Territory *territory) {
+    freeze();
+    const vector<int> &adjOffsets = topology->adjOffsets;
+    int id = territory->getId();
+    return Span<Territory *>(adjTerritories.data() + adjOffsets[id], adjTerritories.data() + adjOffsets[id + 1]);
 }
 
-Map::~Map() {
-    for (auto territory : territories) {
-        delete territory;
+/**
+ * Returns the territories which neighbor a set of territories without being part of it.
+ *
+ * For a player's owned territories, this is the enemy frontier.
+ *
+ * @param owned ids of the territories
+ * @return ids of the neighboring territories
+ */
+Bitset Map::getFrontier(const Bitset &owned) {
+    freeze();
+    Bitset frontier(territories.size());
+    for (int id = owned.next(0); id != -1; id = owned.next(id + 1)) {
+        for (int neighborId : neighbors(id)) {
+            frontier.set(neighborId);
+        }
     }
-    territories.clear();
+    frontier.andNot(owned);
+    return frontier;
+}
 
-    for (auto continent : continents) {
-        delete continent;
-    }
-    territories.clear();
+/**
+ * Returns the ids of the neighbors of a given territory, sorted by id. The map must be frozen.
+ *
+ * @param territoryId
+ * @return a view over the neighbor ids, valid until the map is modified
+ */
+Span<int> Map::neighbors(int territoryId) const {
+    return topology->neighbors(territoryId);
+}
+
+// Continents are owned by the topology, which is deleted with the last map sharing it
+Map::~Map() {
+    delete store;
 }
 
 //=============================
 // Continent Implementation
 //=============================
 
-Continent::Continent(string name, int armyValue)
-        : name{name},
+Continent::Continent(int id, string name, int armyValue)
+        : id{id},
+          name{name},
           armies{armyValue} {}
 
 Continent::Continent(const Continent &other)
-        : name{other.name},
+        : id{other.id},
+          name{other.name},
           armies{other.armies} {}
 
 /**
@@ -337,6 +578,7 @@ Continent::Continent(const Continent &other)
 void swap(Continent &a, Continent &b) {
     using std::swap;
 
+    swap(a.id, b.id);
     swap(a.name, b.name);
     swap(a.armies, b.armies);
 }
@@ -354,6 +596,10 @@ ostream &operator<<(ostream &out, const Continent &obj) {
     return out;
 }
 
+int Continent::getId() const {
+    return id;
+}
+
 const string &Continent::getName() const {
     return name;
 }
@@ -364,23 +610,351 @@ const int &Continent::getArmies() const {
 
 Continent::~Continent() = default;
 
+//=============================
+// MapTopology Implementation
+//=============================
+
+MapTopology::MapTopology()
+        : names{},
+          continents{},
+          territoryContinents{},
+          continentTerritories{},
+          continentMasks{},
+          connections{},
+          frozen{false},
+          adjOffsets{},
+          adjIds{} {}
+
+// Continents are copied, and territories of the copied continents are pointed to the copies
+MapTopology::MapTopology(const MapTopology &other)
+        : names{other.names},
+          continents{},
+          territoryContinents{other.territoryContinents},
+          continentTerritories{other.continentTerritories},
+          continentMasks{other.continentMasks},
+          connections{other.connections},
+          frozen{other.frozen},
+          adjOffsets{other.adjOffsets},
+          adjIds{other.adjIds} {
+    for (auto continent : other.continents) {
+        continents.push_back(new Continent(*continent));
+    }
+    for (auto &continent : territoryContinents) {
+        int continentId = continent->getId();
+        if (continentId >= 0 && continentId < continents.size() && other.continents[continentId] == continent) {
+            continent = continents[continentId];
+        }
+    }
+}
+
+/**
+ * Swap method. Used for the copy-and-swap idiom
+ *
+ * @param a first element
+ * @param b second element
+ */
+void swap(MapTopology &a, MapTopology &b) {
+    using std::swap;
+
+    swap(a.names, b.names);
+    swap(a.continents, b.continents);
+    swap(a.territoryContinents, b.territoryContinents);
+    swap(a.continentTerritories, b.continentTerritories);
+    swap(a.continentMasks, b.continentMasks);
+    swap(a.connections, b.connections);
+    swap(a.frozen, b.frozen);
+    swap(a.adjOffsets, b.adjOffsets);
+    swap(a.adjIds, b.adjIds);
+}
+
+MapTopology &MapTopology::operator=(MapTopology other) {
+    swap(*this, other);
+    return *this;
+}
+
+ostream &operator<<(ostream &out, const MapTopology &obj) {
+    out << "MapTopology{ "
+        << "territories: " << obj.size()
+        << ", continents: " << obj.continents.size()
+        << ", connections: " << obj.connections.size()
+        << ", frozen: " << obj.frozen
+        << " }";
+    return out;
+}
+
+int MapTopology::size() const {
+    return names.size();
+}
+
+bool MapTopology::isFrozen() const {
+    return frozen;
+}
+
+const string &MapTopology::getName(int id) const {
+    return names[id];
+}
+
+Continent *MapTopology::getContinent(int id) const {
+    return territoryContinents[id];
+}
+
+const vector<Continent *> &MapTopology::getContinents() const {
+    return continents;
+}
+
+/**
+ * Returns the ids of the territories added to a continent
+ *
+ * @param continentId
+ * @return a view over the territory ids, in the order they were added. Empty if there is no such continent
+ */
+Span<int> MapTopology::getTerritoriesByContinent(int continentId) const {
+    if (continentId < 0 || continentId >= continentTerritories.size()) {
+        return Span<int>();
+    }
+    const vector<int> &ids = continentTerritories[continentId];
+    return Span<int>(ids.data(), ids.data() + ids.size());
+}
+
+/**
+ * Returns the ids of the territories added to a continent, as a mask
+ *
+ * @param continentId
+ */
+const Bitset &MapTopology::getContinentMask(int continentId) const {
+    return continentMasks[continentId];
+}
+
+/**
+ * Returns the ids of the neighbors of a given territory, sorted by id. The topology must be frozen.
+ *
+ * @param territoryId
+ */
+Span<int> MapTopology::neighbors(int territoryId) const {
+    return Span<int>(adjIds.data() + adjOffsets[territoryId], adjIds.data() + adjOffsets[territoryId + 1]);
+}
+
+/**
+ * Returns whether two territories are adjacent, by id. The topology must be frozen.
+ *
+ * @param t1 The id of the first territory
+ * @param t2 The id of the second territory
+ */
+bool MapTopology::areAdjacent(int t1, int t2) const {
+    Span<int> row = neighbors(t1);
+    const int *found = lower_bound(row.begin(), row.end(), t2);
+    return found != row.end() && *found == t2;
+}
+
+MapTopology::~MapTopology() {
+    for (auto continent : continents) {
+        delete continent;
+    }
+}
+
+//=============================
+// TerritoryStore Implementation
+//=============================
+
+TerritoryStore::TerritoryStore(const MapTopology *topology)
+        : armies{},
+          reservedArmies{},
+          owners{},
+          players{nullptr},
+          playerIndices{},
+          topology{topology},
+          moveLog{nullptr} {}
+
+ostream &operator<<(ostream &out, const TerritoryStore &obj) {
+    out << "TerritoryStore{ "
+        << "territories: " << obj.size()
+        << ", players: " << obj.players.size() - 1
+        << " }";
+    return out;
+}
+
+/**
+ * Adds a territory without an owner. Its name and continent are added to the topology by the map
+ *
+ * @param armies
+ * @return id of the new territory
+ */
+int TerritoryStore::add(int armies) {
+    this->armies.push_back(armies);
+    reservedArmies.push_back(0);
+    owners.push_back(0);
+    return owners.size() - 1;
+}
+
+/**
+ * Reserves room for a number of territories
+ *
+ * @param territoryCount
+ */
+void TerritoryStore::reserve(int territoryCount) {
+    armies.reserve(territoryCount);
+    reservedArmies.reserve(territoryCount);
+    owners.reserve(territoryCount);
+}
+
+/**
+ * Returns the owner index of a player, registering the player if it wasn't seen yet
+ *
+ * @throws runtime_error if there is no owner index left for a new player
+ */
+uint16_t TerritoryStore::registerPlayer(Player *player) {
+    if (player == nullptr) {
+        return 0;
+    }
+    auto found = playerIndices.find(player);
+    if (found != playerIndices.end()) {
+        return found->second;
+    }
+    if (players.size() > UINT16_MAX) {
+        throw runtime_error("Too many players for 16-bit owner indices");
+    }
+    uint16_t ownerIndex = players.size();
+    if (moveLog != nullptr) {
+        moveLog->recordPlayerRegistered(this, player);
+    }
+    players.push_back(player);
+    playerIndices.emplace(player, ownerIndex);
+    return ownerIndex;
+}
+
+/**
+ * Forgets the player registered last, which must not own any territory
+ */
+void TerritoryStore::unregisterLastPlayer() {
+    playerIndices.erase(players.back());
+    players.pop_back();
+}
+
+/**
+ * Removes the owner of every territory
+ */
+void TerritoryStore::clearOwners() {
+    std::fill(owners.begin(), owners.end(), 0);
+    players.assign(1, nullptr);
+    playerIndices.clear();
+}
+
+int TerritoryStore::size() const {
+    return owners.size();
+}
+
+/**
+ * Returns the number of owner indices in use, including the index meaning no owner
+ */
+int TerritoryStore::getPlayerCount() const {
+    return players.size();
+}
+
+const string &TerritoryStore::getName(int id) const {
+    return topology->getName(id);
+}
+
+int32_t TerritoryStore::getArmies(int id) const {
+    return armies[id];
+}
+
+int32_t TerritoryStore::getReservedArmies(int id) const {
+    return reservedArmies[id];
+}
+
+Player *TerritoryStore::getOwner(int id) const {
+    return players[owners[id]];
+}
+
+uint16_t TerritoryStore::getOwnerIndex(int id) const {
+    return owners[id];
+}
+
+Continent *TerritoryStore::getContinent(int id) const {
+    return topology->getContinent(id);
+}
+
+/**
+ * Returns the armies of every territory, indexed by territory id
+ */
+Span<int32_t> TerritoryStore::getAllArmies() const {
+    return Span<int32_t>(armies.data(), armies.data() + armies.size());
+}
+
+/**
+ * Returns the reserved armies of every territory, indexed by territory id
+ */
+Span<int32_t> TerritoryStore::getAllReservedArmies() const {
+    return Span<int32_t>(reservedArmies.data(), reservedArmies.data() + reservedArmies.size());
+}
+
+/**
+ * Returns the owner index of every territory, indexed by territory id
+ *
+ * @see getPlayer
+ */
+Span<uint16_t> TerritoryStore::getAllOwners() const {
+    return Span<uint16_t>(owners.data(), owners.data() + owners.size());
+}
+
+/**
+ * Returns the player with a given owner index, or null for index 0
+ */
+Player *TerritoryStore::getPlayer(uint16_t ownerIndex) const {
+    return players[ownerIndex];
+}
+
+void TerritoryStore::setArmies(int id, int32_t armies) {
+    if (moveLog != nullptr) {
+        moveLog->recordArmies(this, id, this->armies[id], armies);
+    }
+    this->armies[id] = armies;
+}
+
+void TerritoryStore::setReservedArmies(int id, int32_t reservedArmies) {
+    if (moveLog != nullptr) {
+        moveLog->recordReservedArmies(this, id, this->reservedArmies[id], reservedArmies);
+    }
+    this->reservedArmies[id] = reservedArmies;
+}
+
+void TerritoryStore::setOwner(int id, Player *player) {
+    uint16_t ownerIndex = registerPlayer(player);
+    if (moveLog != nullptr) {
+        moveLog->recordOwner(this, id, owners[id], ownerIndex);
+    }
+    owners[id] = ownerIndex;
+}
+
+/**
+ * Sets the topology names and continents are looked up in, for stores of maps which copied it
+ *
+ * @param topology
+ */
+void TerritoryStore::setTopology(const MapTopology *topology) {
+    this->topology = topology;
+}
+
+/**
+ * Records the changes to armies, reserved armies and owners in a log, or stops recording them when null
+ *
+ * @param moveLog
+ */
+void TerritoryStore::setMoveLog(MoveLog *moveLog) {
+    this->moveLog = moveLog;
+}
+
 //=============================
 // Territory Implementation
 //=============================
 
-Territory::Territory(string name, Continent *continent, int armies)
-        : name{name},
-          continent{continent},
-          armies{armies},
-          reservedArmies{0},
-          player{nullptr} {}
+Territory::Territory(TerritoryStore *store, int id)
+        : store{store},
+          id{id} {}
 
 Territory::Territory(const Territory &other)
-        : name{other.name},
-          continent{other.continent},
-          armies{other.armies},
-          reservedArmies{other.reservedArmies},
-          player{nullptr} {}
+        : store{other.store},
+          id{other.id} {}
 
 Territory &Territory::operator=(Territory other) {
     swap(*this, other);
@@ -396,18 +970,15 @@ Territory &Territory::operator=(Territory other) {
 void swap(Territory &a, Territory &b) {
     using std::swap;
 
-    swap(a.name, b.name);
-    swap(a.armies, b.armies);
-    swap(a.reservedArmies, b.reservedArmies);
-    swap(a.continent, b.continent);
-    swap(a.player, b.player);
+    swap(a.store, b.store);
+    swap(a.id, b.id);
 }
 
 ostream &operator<<(ostream &out, const Territory &obj) {
     out << "Territory{"
-        << " name: " << obj.name
-        << ", continent: " << obj.continent->getName()
-        << ", armies: " << obj.armies
+        << " name: " << obj.store->getName(obj.id)
+        << ", continent: " << obj.getContinent()->getName()
+        << ", armies: " << obj.getArmies()
         << ", availableArmies: " << obj.getAvailableArmies()
         << " }";
 
@@ -420,7 +991,7 @@ ostream &operator<<(ostream &out, const Territory &obj) {
  * @param armies
  */
 void Territory::addArmies(int armies) {
-    this->armies += armies;
+    store->setArmies(id, store->getArmies(id) + armies);
 }
 
 /**
@@ -429,10 +1000,8 @@ void Territory::addArmies(int armies) {
  * @param armies
  */
 void Territory::removeArmies(int armies) {
-    this->armies -= armies;
-    if (this->armies < 0) {
-        this->armies = 0;
-    }
+    int remaining = store->getArmies(id) - armies;
+    store->setArmies(id, remaining < 0 ? 0 : remaining);
 }
 
 /**
@@ -441,7 +1010,7 @@ void Territory::removeArmies(int armies) {
  * @param armies
  */
 void Territory::reserveArmies(int armies) {
-    reservedArmies += armies;
+    store->setReservedArmies(id, store->getReservedArmies(id) + armies);
 }
 
 /**
@@ -450,17 +1019,15 @@ void Territory::reserveArmies(int armies) {
  * @param armies
  */
 void Territory::freeArmies(int armies) {
-    reservedArmies -= armies;
-    if (reservedArmies < 0) {
-        reservedArmies = 0;
-    }
+    int remaining = store->getReservedArmies(id) - armies;
+    store->setReservedArmies(id, remaining < 0 ? 0 : remaining);
 }
 
 /**
  * Free all armies from reservations from AdvanceOrders or AirliftOrders
  */
 void Territory::freeArmies() {
-    reservedArmies = 0;
+    store->setReservedArmies(id, 0);
 }
 
 /**
@@ -469,10 +1036,11 @@ void Territory::freeArmies() {
  * @return armies available for AdvanceOrders or AirliftOrders
  */
 int Territory::getAvailableArmies() const {
-    if (armies - reservedArmies < 0) {
+    int available = store->getArmies(id) - store->getReservedArmies(id);
+    if (available < 0) {
         return 0;
     }
-    return armies - reservedArmies;
+    return available;
 }
 
 /**
@@ -481,7 +1049,7 @@ int Territory::getAvailableArmies() const {
  * @see BombOrder
  */
 void Territory::bomb() {
-    this->armies /= 2;
+    store->setArmies(id, store->getArmies(id) / 2);
 }
 
 /**
@@ -490,7 +1058,7 @@ void Territory::bomb() {
  * @see BlockadeOrder
  */
 void Territory::blockade() {
-    this->armies *= 3;
+    store->setArmies(id, store->getArmies(id) * 3);
 }
 
 /**
@@ -503,40 +1071,339 @@ void Territory::blockade() {
  * @return whether the current territory can attack
  */
 bool Territory::canAttack(Map *map) {
-    for (auto &neighbor : map->getNeighbors(this)) {
-        if (player != neighbor->getPlayer()) {
+    map->freeze();
+    Span<uint16_t> owners = store->getAllOwners();
+    for (int neighborId : map->neighbors(id)) {
+        if (owners[neighborId] != owners[id]) {
             return true;
         }
     }
     return false;
 }
 
+int Territory::getId() const {
+    return id;
+}
+
 const string &Territory::getName() {
-    return name;
+    return store->getName(id);
 }
 
 int Territory::getArmies() const {
-    return armies;
+    return store->getArmies(id);
 }
 
 Continent *Territory::getContinent() const {
-    return continent;
+    return store->getContinent(id);
 }
 
 Player *Territory::getPlayer() {
-    return player;
-}
-
-void Territory::setContinent(Continent *continent) {
-    this->continent = continent;
+    return store->getOwner(id);
 }
 
 void Territory::setPlayer(Player *player) {
-    this->player = player;
+    store->setOwner(id, player);
 }
 
 Territory::~Territory() {}
 
+//=============================
+// MapChecker Implementation
+//=============================
+
+ostream &operator<<(ostream &out, const MapError &obj) {
+    out << "INVALID MAP";
+    if (obj.line > 0) {
+        out << " AT LINE " << obj.line;
+    }
+    out << ": " << obj.message;
+    return out;
+}
+
+/**
+ * @param errors list the problems found are added to
+ */
+MapChecker::MapChecker(vector<MapError> &errors)
+        : errors{&errors},
+          continentNames{},
+          territoryNames{},
+          territoryContinents{},
+          mapParent{},
+          continentParent{},
+          mapComponents{0},
+          continentComponents{},
+          borders{},
+          valid{true} {}
+
+ostream &operator<<(ostream &out, const MapChecker &obj) {
+    out << "MapChecker{ "
+        << "continents: " << obj.continentNames.size()
+        << ", territories: " << obj.territoryNames.size()
+        << ", borders: " << obj.borders.size()
+        << ", valid: " << obj.valid
+        << " }";
+    return out;
+}
+
+/**
+ * Makes room for a number of borders, for loaders which know them in advance
+ *
+ * @param borderCount number of borders, as listed
+ */
+void MapChecker::reserveBorders(int borderCount) {
+    borders.reserve(borderCount);
+}
+
+/**
+ * Adds an error to the list, making the map invalid
+ *
+ * @param type
+ * @param line line of the map file, or 0
+ * @param message
+ */
+void MapChecker::addError(MapError::Type type, int line, string message) {
+    errors->push_back({type, line, std::move(message)});
+    valid = false;
+}
+
+/**
+ * Checks the next continent of the map
+ *
+ * @param name
+ * @param line line of the map file, or 0
+ * @return whether the map is still valid
+ */
+bool MapChecker::addContinent(string_view name, int line) {
+    int id = continentNames.size();
+    if (continentNames.intern(name) != id) {
+        addError(MapError::Type::DUPLICATE_NAME, line, "DUPLICATE CONTINENT " + string(name));
+        return false;
+    }
+    continentComponents.push_back(0);
+    return valid;
+}
+
+/**
+ * Checks the next territory of the map
+ *
+ * @param name
+ * @param continent index of the continent
+ * @param line line of the map file, or 0
+ * @return whether the map is still valid
+ */
+bool MapChecker::addTerritory(string_view name, int continent, int line) {
+    if (continent < 0 || continent >= continentNames.size()) {
+        addError(MapError::Type::INVALID_CONTINENT, line, "TERRITORY " + string(name) + " HAS A NON-EXISTENT CONTINENT");
+        return false;
+    }
+    int id = territoryNames.size();
+    if (territoryNames.intern(name) != id) {
+        addError(MapError::Type::DUPLICATE_NAME, line, "DUPLICATE TERRITORY " + string(name));
+        return false;
+    }
+    territoryContinents.push_back(continent);
+    mapParent.push_back(id);
+    continentParent.push_back(id);
+    mapComponents++;
+    continentComponents[continent]++;
+    return valid;
+}
+
+/**
+ * Checks a border as listed by a map file, from a territory to one of its neighbors. Every border must
+ * also be listed the other way, which finish checks
+ *
+ * @param from index of the territory listing the border
+ * @param to index of the neighbor
+ * @param line line of the map file, or 0
+ * @return whether the map is still valid
+ */
+bool MapChecker::addBorder(int from, int to, int line) {
+    if (!checkBorder(from, to, line)) {
+        return false;
+    }
+    borders.emplace_back(from, to);
+    connect(from, to);
+    return valid;
+}
+
+/**
+ * Checks a connection between two territories, which goes both ways
+ *
+ * @param t1 index of the first territory
+ * @param t2 index of the second territory
+ * @return whether the map is still valid
+ */
+bool MapChecker::addConnection(int t1, int t2) {
+    if (!checkBorder(t1, t2, 0)) {
+        return false;
+    }
+    connect(t1, t2);
+    return valid;
+}
+
+/**
+ * Checks what can only be checked once the whole map was added: that it has continents and
+ * territories, that every border is listed both ways, and that the map and each continent are
+ * connected. The territories are only walked to describe the components of a disconnected map.
+ *
+ * @return whether the map is valid
+ */
+bool MapChecker::finish() {
+    if (!valid) {
+        return false;
+    }
+    if (continentNames.size() == 0) {
+        addError(MapError::Type::EMPTY_MAP, 0, "EMPTY CONTINENT LIST");
+        return false;
+    }
+    if (territoryNames.size() == 0) {
+        addError(MapError::Type::EMPTY_MAP, 0, "EMPTY TERRITORY LIST");
+        return false;
+    }
+
+    vector<pair<int, int>> unmatched = findUnmatchedBorders();
+    for (int i = 0; i < unmatched.size() && i < MAX_REPORTED_BORDERS; ++i) {
+        string_view from = territoryNames.getName(unmatched[i].first);
+        string_view to = territoryNames.getName(unmatched[i].second);
+        addError(MapError::Type::ASYMMETRIC_BORDER, 0, "BORDER FROM " + string(from) + " TO " + string(to)
+                                                       + " ISN'T LISTED BY " + string(to));
+    }
+    if (unmatched.size() > MAX_REPORTED_BORDERS) {
+        addError(MapError::Type::ASYMMETRIC_BORDER, 0, "AND " + std::to_string(unmatched.size() - MAX_REPORTED_BORDERS)
+                                                       + " MORE BORDERS LISTED BY ONE TERRITORY ONLY");
+    }
+
+    int numTerritories = territoryNames.size();
+    if (mapComponents > 1) {
+        vector<int> ids(numTerritories);
+        for (int i = 0; i < numTerritories; ++i) {
+            ids[i] = i;
+            mapParent[i] = findRoot(mapParent, i);
+        }
+        sort(ids.begin(), ids.end(), [this](int t1, int t2) {
+            return pair<int, int>(mapParent[t1], t1) < pair<int, int>(mapParent[t2], t2);
+        });
+        addError(MapError::Type::DISCONNECTED_MAP, 0, "NOT A CONNECTED GRAPH. IT IS SPLIT INTO "
+                                                      + std::to_string(mapComponents) + " COMPONENTS:"
+                                                      + describeComponents(ids, mapParent));
+    }
+
+    for (int continent = 0; continent < continentComponents.size(); ++continent) {
+        if (continentComponents[continent] <= 1) {
+            continue;
+        }
+        vector<int> ids;
+        for (int i = 0; i < numTerritories; ++i) {
+            if (territoryContinents[i] == continent) {
+                ids.push_back(i);
+                continentParent[i] = findRoot(continentParent, i);
+            }
+        }
+        sort(ids.begin(), ids.end(), [this](int t1, int t2) {
+            return pair<int, int>(continentParent[t1], t1) < pair<int, int>(continentParent[t2], t2);
+        });
+        addError(MapError::Type::DISCONNECTED_CONTINENT, 0,
+                 "THE TERRITORIES OF CONTINENT " + string(continentNames.getName(continent))
+                 + " AREN'T CONNECTED. THEY ARE SPLIT INTO " + std::to_string(continentComponents[continent])
+                 + " COMPONENTS:" + describeComponents(ids, continentParent));
+    }
+    return valid;
+}
+
+/**
+ * Returns the index of a continent, or -1 if there is none with that name
+ */
+int MapChecker::findContinent(string_view name) const {
+    return continentNames.find(name);
+}
+
+/**
+ * Returns the index of a territory, or -1 if there is none with that name
+ */
+int MapChecker::findTerritory(string_view name) const {
+    return territoryNames.find(name);
+}
+
+int MapChecker::territoryCount() const {
+    return territoryNames.size();
+}
+
+/**
+ * Checks that a border joins two different territories which exist. Territories are counted from 1 in
+ * the messages, like in map files
+ */
+bool MapChecker::checkBorder(int from, int to, int line) {
+    int numTerritories = territoryNames.size();
+    if (from < 0 || from >= numTerritories) {
+        addError(MapError::Type::INVALID_TERRITORY, line,
+                 "BORDERS OF NON-EXISTENT TERRITORY " + std::to_string(from + 1));
+        return false;
+    }
+    if (to < 0 || to >= numTerritories) {
+        addError(MapError::Type::DANGLING_BORDER, line, "BORDER FROM " + string(territoryNames.getName(from))
+                                                        + " TO NON-EXISTENT TERRITORY " + std::to_string(to + 1));
+        return false;
+    }
+    if (from == to) {
+        addError(MapError::Type::DANGLING_BORDER, line, "BORDER FROM " + string(territoryNames.getName(from))
+                                                        + " TO ITSELF");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Matches every listed border with its reverse, after sorting them
+ *
+ * @return the borders whose reverse isn't listed, sorted
+ */
+vector<pair<int, int>> MapChecker::findUnmatchedBorders() {
+    sort(borders.begin(), borders.end());
+    borders.erase(std::unique(borders.begin(), borders.end()), borders.end());
+    vector<pair<int, int>> unmatched;
+    for (auto &border : borders) {
+        if (!std::binary_search(borders.begin(), borders.end(), pair<int, int>(border.second, border.first))) {
+            unmatched.push_back(border);
+        }
+    }
+    return unmatched;
+}
+
+/**
+ * Merges the components of two territories, in the map and, if they share it, in their continent
+ */
+void MapChecker::connect(int t1, int t2) {
+    if (unite(mapParent, t1, t2)) {
+        mapComponents--;
+    }
+    int continent = territoryContinents[t1];
+    if (continent == territoryContinents[t2] && unite(continentParent, t1, t2)) {
+        continentComponents[continent]--;
+    }
+}
+
+/**
+ * Describes each connected component of a list of territories on its own line
+ *
+ * @param ids territory ids, sorted by root and then by id
+ * @param parent union-find forest in which every territory of the list points directly to its root
+ */
+string MapChecker::describeComponents(const vector<int> &ids, const vector<int> &parent) {
+    string description;
+    for (int i = 0; i < ids.size(); ++i) {
+        if (i == 0 || parent[ids[i]] != parent[ids[i - 1]]) {
+            description += "\n\t( ";
+        }
+        description += territoryNames.getName(ids[i]);
+        description += " ";
+        if (i + 1 == ids.size() || parent[ids[i + 1]] != parent[ids[i]]) {
+            description += ")";
+        }
+    }
+    return description;
+}
+
 
 
 
@@ -1,30 +1,60 @@
 #pragma once
 
+#include <cstdint>
+#include <deque>
+#include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <map>
 
+#include "../utils/Utils.h"
+#include "../utils/Bitset.h"
+#include "../utils/NameTable.h"
+
+using std::deque;
 using std::map;
 using std::ostream;
+using std::pair;
 using std::set;
+using std::shared_ptr;
 using std::string;
+using std::string_view;
 using std::vector;
 
 class Map;
+class MapTopology;
+class TerritoryStore;
 class Territory;
 class Continent;
 class Player;
+class MoveLog;
 
 /**
  * Class which represent the map on which the game takes place
+ *
+ * What doesn't change during a game, the names, continents and borders, is kept in a MapTopology
+ * shared by the copies of the map. A copy only gets its own TerritoryStore and territory handles, so
+ * copying a map for a new game or a search doesn't copy names or adjacency. A map which is modified
+ * while its topology is shared gets its own copy of the topology first.
  */
 class Map {
 private:
     string name;
+    shared_ptr<MapTopology> topology;
+    // State of every territory in this game. The territories themselves are handles into it
+    TerritoryStore *store;
+    deque<Territory> territoryHandles;
     vector<Territory *> territories;
-    vector<Continent *> continents;
-    map<Territory *, set<Territory *>> adj;
+    // Territories of each continent and neighbors of each territory, as handles of this map. They
+    // follow the ids of the topology
+    vector<vector<Territory *>> continentTerritories;
+    vector<Territory *> adjTerritories;
+
+    MapTopology &editTopology();
+    void addHandle(int id);
+    void bindAdjacency();
 
 public:
     Map(string name);
@@ -38,12 +68,25 @@ public:
                       int armies);
     void addContinent(string name, int armyValue);
     void addConnection(int t1, int t2);
+    void reserve(int territoryCount, int continentCount);
+    void freeze();
+    void setAdjacency(cris_utils::Span<int> offsets, cris_utils::Span<int> ids);
+    void setContinent(Territory *territory, Continent *continent);
     bool validate();
+    bool validate(ostream &out);
     const vector<Territory *> &getTerritories() const;
-    const set<Territory *> getTerritoriesByContinent(Continent *continent) const;
+    const vector<Continent *> &getContinents() const;
+    const TerritoryStore &getTerritoryStore() const;
+    shared_ptr<const MapTopology> getTopology() const;
+    cris_utils::Span<Territory *> getTerritoriesByContinent(Continent *continent) const;
     bool areAdjacent(Territory *t1, Territory *t2);
     set<Continent *> getContinentsControlledByPlayer(Player *player);
-    const set<Territory *> getNeighbors(Territory *territory);
+    const cris_utils::Bitset &getContinentMask(Continent *continent) const;
+    cris_utils::Span<Territory *> getNeighbors(Territory *territory);
+    cris_utils::Bitset getFrontier(const cris_utils::Bitset &owned);
+    cris_utils::Span<int> neighbors(int territoryId) const;
+    bool areAdjacent(int t1, int t2) const;
+    void setMoveLog(MoveLog *moveLog);
 
     ~Map();
 };
@@ -53,37 +96,151 @@ public:
  */
 class Continent {
 private:
+    int id;
     string name;
     int armies;
 
 public:
-    Continent(string name, int armyValue);
+    Continent(int id, string name, int armyValue);
     Continent(const Continent &other);
     friend void swap(Continent &a, Continent &b);
     Continent &operator=(Continent other);
     friend ostream &operator<<(ostream &out, const Continent &obj);
 
+    int getId() const;
     const string &getName() const;
     const int &getArmies() const;
 
     ~Continent();
 };
 
+/**
+ * Names, continents and borders of a map, which don't change once the map is loaded.
+ *
+ * A topology is built by its map, then shared read-only by the copies of that map, including copies
+ * used by other threads. Territories are identified by id: territory i is the i-th territory added.
+ * The adjacency is kept in compressed sparse row form, built by Map::freeze: the neighbors of territory
+ * i are adjIds[adjOffsets[i]] to adjIds[adjOffsets[i + 1] - 1], sorted by id.
+ *
+ * The topology owns its continents, so copying it copies them, and territories of copied continents
+ * refer to the copies.
+ */
+class MapTopology {
+private:
+    vector<string> names;
+    vector<Continent *> continents;
+    // Continent of each territory, indexed by territory id
+    vector<Continent *> territoryContinents;
+    // Territory ids of each continent, as a list and as a mask, indexed by continent id
+    vector<vector<int>> continentTerritories;
+    vector<cris_utils::Bitset> continentMasks;
+    // Connections as they were added, used to (re)build the adjacency arrays
+    vector<pair<int, int>> connections;
+
+    bool frozen;
+    vector<int> adjOffsets;
+    vector<int> adjIds;
+
+    friend class Map;
+
+public:
+    MapTopology();
+    MapTopology(const MapTopology &other);
+    friend void swap(MapTopology &a, MapTopology &b);
+    MapTopology &operator=(MapTopology other);
+    friend ostream &operator<<(ostream &out, const MapTopology &obj);
+
+    int size() const;
+    bool isFrozen() const;
+    const string &getName(int id) const;
+    Continent *getContinent(int id) const;
+    const vector<Continent *> &getContinents() const;
+    cris_utils::Span<int> getTerritoriesByContinent(int continentId) const;
+    const cris_utils::Bitset &getContinentMask(int continentId) const;
+    cris_utils::Span<int> neighbors(int territoryId) const;
+    bool areAdjacent(int t1, int t2) const;
+
+    ~MapTopology();
+};
+
+ostream &operator<<(ostream &out, const MapTopology &obj);
+
+/**
+ * State of all the territories of a map in one game, stored as one array per field and indexed by
+ * territory id.
+ *
+ * Only what changes during a game is stored here: armies, reserved armies and owners, kept in small
+ * contiguous arrays which are quick to scan and to copy. Names and continents are looked up in the
+ * topology of the map. Owners are stored as indices into a registry of the players seen so far; owner 0
+ * means the territory has no owner.
+ *
+ * Note that the store isn't responsible for the memory of players and of the topology, so the default
+ * copy constructor, assignment operator and destructor are used
+ */
+class TerritoryStore {
+private:
+    vector<int32_t> armies;
+    vector<int32_t> reservedArmies;
+    vector<uint16_t> owners;
+
+    // Players by owner index, and owner index of each player
+    vector<Player *> players;
+    std::unordered_map<Player *, uint16_t> playerIndices;
+    const MapTopology *topology;
+    // Log the changes are recorded in, if any
+    MoveLog *moveLog;
+
+public:
+    explicit TerritoryStore(const MapTopology *topology);
+    friend ostream &operator<<(ostream &out, const TerritoryStore &obj);
+
+    int add(int armies);
+    void reserve(int territoryCount);
+    uint16_t registerPlayer(Player *player);
+    void clearOwners();
+
+    int size() const;
+    int getPlayerCount() const;
+    const string &getName(int id) const;
+    int32_t getArmies(int id) const;
+    int32_t getReservedArmies(int id) const;
+    Player *getOwner(int id) const;
+    uint16_t getOwnerIndex(int id) const;
+    Continent *getContinent(int id) const;
+    cris_utils::Span<int32_t> getAllArmies() const;
+    cris_utils::Span<int32_t> getAllReservedArmies() const;
+    cris_utils::Span<uint16_t> getAllOwners() const;
+    Player *getPlayer(uint16_t ownerIndex) const;
+
+    void setArmies(int id, int32_t armies);
+    void setReservedArmies(int id, int32_t reservedArmies);
+    void setOwner(int id, Player *player);
+    void setTopology(const MapTopology *topology);
+    void setMoveLog(MoveLog *moveLog);
+
+private:
+    // Reverts and replays changes directly, without recording them again
+    friend class MoveLog;
+
+    void unregisterLastPlayer();
+};
+
+ostream &operator<<(ostream &out, const TerritoryStore &obj);
+
 /**
  * Class for representing a Territory on a Map.
+ *
+ * A territory is a lightweight handle to its state in the map's TerritoryStore. Copying a territory
+ * copies the handle, so the copy refers to the same territory. The continent of a territory is part of
+ * the map's topology, see Map::setContinent.
  */
 class Territory {
 private:
-    string name;
-    int armies;
-    int reservedArmies;
-    Continent *continent;
-    Player *player;
+    TerritoryStore *store;
+    int id;
 
 public:
-    Territory(string name,
-              Continent *continent,
-              int armies);
+    Territory(TerritoryStore *store, int id);
     Territory(const Territory &other);
     friend void swap(Territory &a, Territory &b);
     Territory &operator=(Territory other);
@@ -99,13 +256,95 @@ public:
     void blockade();
     bool canAttack(Map *map);
 
+    int getId() const;
     const string &getName();
     int getArmies() const;
     Continent *getContinent() const;
     Player *getPlayer();
 
-    void setContinent(Continent *continent);
     void setPlayer(Player *player);
 
     ~Territory();
 };
+
+/**
+ * Problem found in a map while it is loaded or validated
+ */
+struct MapError {
+    enum class Type {
+        // Line or file which can't be read
+        MALFORMED_FILE,
+        DUPLICATE_NAME,
+        INVALID_CONTINENT,
+        INVALID_TERRITORY,
+        // Border to a territory which doesn't exist, or to the territory itself
+        DANGLING_BORDER,
+        // Border listed by one of its territories only
+        ASYMMETRIC_BORDER,
+        EMPTY_MAP,
+        DISCONNECTED_MAP,
+        DISCONNECTED_CONTINENT,
+    };
+
+    Type type;
+    // Line of the map file the problem is on, or 0 if it isn't tied to a line
+    int line;
+    string message;
+};
+
+ostream &operator<<(ostream &out, const MapError &obj);
+
+/**
+ * Checks a map while it is built, one continent, territory or border at a time, so a loader can
+ * validate a map in the same pass which reads it.
+ *
+ * Each call checks what it is given against what was added before: ids in range, names not seen yet,
+ * borders not pointing to the territory itself. It returns false as soon as the map is invalid, so the
+ * loader can stop there. Connectivity is tracked as borders arrive, with union-find forests of the map
+ * and of the continents. Borders are kept as listed, and finish sorts them once to match each with its
+ * reverse. Once everything is added, finish reports what can only be known at the end, without walking
+ * the map again.
+ *
+ * Names are kept as views, so the text they come from must outlive the checker.
+ *
+ * Note that the checker isn't responsible for the memory of the error list, so the default copy
+ * constructor, assignment operator and destructor are used
+ */
+class MapChecker {
+private:
+    vector<MapError> *errors;
+    cris_utils::NameTable continentNames;
+    cris_utils::NameTable territoryNames;
+    vector<int> territoryContinents;
+    // Union-find forests over every connection, and over the connections within a continent
+    vector<int> mapParent;
+    vector<int> continentParent;
+    int mapComponents;
+    vector<int> continentComponents;
+    // Borders as they were listed, matched with their reverse by finish
+    vector<pair<int, int>> borders;
+    // Whether no error was found so far
+    bool valid;
+
+    bool checkBorder(int from, int to, int line);
+    vector<pair<int, int>> findUnmatchedBorders();
+    void connect(int t1, int t2);
+    string describeComponents(const vector<int> &ids, const vector<int> &parent);
+
+public:
+    explicit MapChecker(vector<MapError> &errors);
+    friend ostream &operator<<(ostream &out, const MapChecker &obj);
+
+    void reserveBorders(int borderCount);
+    void addError(MapError::Type type, int line, string message);
+    bool addContinent(string_view name, int line);
+    bool addTerritory(string_view name, int continent, int line);
+    bool addBorder(int from, int to, int line);
+    bool addConnection(int t1, int t2);
+    bool finish();
+    int findContinent(string_view name) const;
+    int findTerritory(string_view name) const;
+    int territoryCount() const;
+};
+
+ostream &operator<<(ostream &out, const MapChecker &obj);
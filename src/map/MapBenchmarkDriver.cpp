@@ -0,0 +1,128 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <set>
+
+#include "Map.h"
+#include "MapGenerator.h"
+#include "../utils/AllocationCounter.h"
+
+using std::cout;
+using std::endl;
+using std::set;
+
+using cris_utils::allocationCount;
+
+namespace {
+    /**
+     * Calls a function on every territory of a map a number of times, and prints the heap allocations
+     * and the time per call
+     *
+     * @param name what the function does
+     * @param visit function called with each territory, returning a value which is summed so the calls
+     * aren't optimized away
+     */
+    template<typename F>
+    void measure(const string &name, Map &map, int passes, F visit) {
+        const vector<Territory *> &territories = map.getTerritories();
+        long sum = 0;
+        long before = allocationCount();
+        auto start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < passes; ++pass) {
+            for (auto &territory : territories) {
+                sum += visit(territory);
+            }
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        long calls = static_cast<long>(passes) * territories.size();
+        double allocationsPerCall = static_cast<double>(allocationCount() - before) / calls;
+
+        cout << name << ": " << allocationsPerCall << " allocations/call, "
+             << elapsed.count() / calls << " ns/call (checksum " << sum << ")" << endl;
+    }
+
+    /**
+     * Validates a map twice, and prints the time taken by each: with Map::validate, which checks the
+     * connections of the map, and with a MapChecker given every border listed by both of its
+     * territories, the way loaders give them
+     */
+    void measureValidation(const string &name, Map &map) {
+        std::ostream discarded(nullptr);
+        auto start = std::chrono::steady_clock::now();
+        bool valid = map.validate(discarded);
+        std::chrono::duration<double, std::milli> validateTime = std::chrono::steady_clock::now() - start;
+
+        vector<MapError> errors;
+        start = std::chrono::steady_clock::now();
+        MapChecker checker(errors);
+        for (auto &continent : map.getContinents()) {
+            checker.addContinent(continent->getName(), 0);
+        }
+        const vector<Territory *> &territories = map.getTerritories();
+        for (auto &territory : territories) {
+            checker.addTerritory(territory->getName(), territory->getContinent()->getId(), 0);
+        }
+        for (auto &territory : territories) {
+            for (auto &neighbor : map.getNeighbors(territory)) {
+                checker.addBorder(territory->getId(), neighbor->getId(), 0);
+            }
+        }
+        bool checked = checker.finish();
+        std::chrono::duration<double, std::milli> checkerTime = std::chrono::steady_clock::now() - start;
+
+        cout << name << " of " << territories.size() << " territories: Map::validate " << validateTime.count()
+             << " ms (valid: " << valid << "), MapChecker with borders both ways " << checkerTime.count()
+             << " ms (valid: " << checked << ")" << endl;
+    }
+}
+
+/**
+ * Benchmark for Map::getNeighbors and map validation
+ *
+ * Compares iterating over the view returned by getNeighbors with copying the neighbors into a set, which
+ * is what getNeighbors used to return, and counts the heap allocations made by each call. Then times
+ * validating chain and grid maps of 10k territories, 10 times more, and so on up to a largest size.
+ * Chains are the worst case of a recursive walk of the map.
+ *
+ * Usage: MapBenchmark [grid width] [passes] [largest validated map]
+ */
+int main(int argc, char *argv[]) {
+    cout << std::boolalpha;
+    int width = argc > 1 ? std::stoi(argv[1]) : 100;
+    int passes = argc > 2 ? std::stoi(argv[2]) : 100;
+    int largest = argc > 3 ? std::stoi(argv[3]) : 1000000;
+
+    Map map = generateGrid(width, width, 1);
+    cout << width * width << " territories, " << passes << " passes" << endl;
+
+    measure("getNeighbors view", map, passes, [&map](Territory *territory) {
+        long sum = 0;
+        for (auto &neighbor : map.getNeighbors(territory)) {
+            sum += neighbor->getId();
+        }
+        return sum;
+    });
+
+    measure("getNeighbors copied to a set", map, passes, [&map](Territory *territory) {
+        cris_utils::Span<Territory *> view = map.getNeighbors(territory);
+        const set<Territory *> neighbors(view.begin(), view.end());
+        long sum = 0;
+        for (auto &neighbor : neighbors) {
+            sum += neighbor->getId();
+        }
+        return sum;
+    });
+
+    measure("Territory::canAttack", map, passes, [&map](Territory *territory) {
+        return territory->canAttack(&map) ? 1L : 0L;
+    });
+    cout << endl;
+
+    for (int territories = 10000; territories <= largest; territories *= 10) {
+        Map chain = generateChain(territories, false, 1);
+        measureValidation("Chain", chain);
+        int side = static_cast<int>(std::sqrt(territories));
+        Map grid = generateGrid(side, territories / side, 1);
+        measureValidation("Grid", grid);
+    }
+}
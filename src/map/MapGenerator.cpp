@@ -0,0 +1,95 @@
+#include "MapGenerator.h"
+
+namespace {
+    // Continents of random maps, at most
+    const int MAX_RANDOM_CONTINENTS = 8;
+}
+
+/**
+ * Generates a map of random size, where each territory is put in a random continent and starts with a
+ * random number of armies. Continents are used in random order, so some may have no territory.
+ *
+ * @param rng
+ * @param maxTerritories largest number of territories
+ * @param connected whether territories are connected: along a random spanning tree, plus about half as
+ * many random connections. Without, the map has no connection
+ */
+Map generateRandomMap(cris_utils::Random &rng, int maxTerritories, bool connected) {
+    Map map("Random map");
+    int numContinents = rng.nextInt(1, MAX_RANDOM_CONTINENTS);
+    int numTerritories = rng.nextInt(connected ? 2 : 1, maxTerritories);
+    for (int i = 0; i < numContinents; ++i) {
+        map.addContinent("c" + std::to_string(i), rng.nextInt(1, 10));
+    }
+    for (int i = 0; i < numTerritories; ++i) {
+        map.addTerritory("t" + std::to_string(i), rng.nextInt(0, numContinents - 1), rng.nextInt(0, 10));
+    }
+    if (connected) {
+        for (int i = 1; i < numTerritories; ++i) {
+            map.addConnection(i, rng.nextInt(0, i - 1));
+        }
+        for (int i = 0; i < numTerritories / 2; ++i) {
+            int t1 = rng.nextInt(0, numTerritories - 1);
+            int t2 = rng.nextInt(0, numTerritories - 1);
+            if (t1 != t2) {
+                map.addConnection(t1, t2);
+            }
+        }
+    }
+    map.freeze();
+    return map;
+}
+
+/**
+ * Generates a chain shaped map, in a single continent, where every territory borders the next one
+ *
+ * @param territories
+ * @param closed whether the last territory also borders the first, making a ring
+ * @param armies armies on each territory
+ */
+Map generateChain(int territories, bool closed, int armies) {
+    Map map((closed ? "Ring " : "Chain ") + std::to_string(territories));
+    map.addContinent("Continent 0", 1);
+    map.reserve(territories, 1);
+    for (int i = 0; i < territories; ++i) {
+        map.addTerritory("t" + std::to_string(i), 0, armies);
+    }
+    for (int i = 0; i + 1 < territories; ++i) {
+        map.addConnection(i, i + 1);
+    }
+    if (closed && territories > 2) {
+        map.addConnection(territories - 1, 0);
+    }
+    map.freeze();
+    return map;
+}
+
+/**
+ * Generates a grid shaped map, in a single continent, where every territory borders the territories
+ * above, below, left and right of it
+ *
+ * @param width
+ * @param height
+ * @param armies armies on each territory
+ */
+Map generateGrid(int width, int height, int armies) {
+    Map map("Grid " + std::to_string(width) + "x" + std::to_string(height));
+    map.addContinent("Continent 0", 1);
+    map.reserve(width * height, 1);
+    for (int i = 0; i < width * height; ++i) {
+        map.addTerritory("t" + std::to_string(i), 0, armies);
+    }
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int id = y * width + x;
+            if (x + 1 < width) {
+                map.addConnection(id, id + 1);
+            }
+            if (y + 1 < height) {
+                map.addConnection(id, id + width);
+            }
+        }
+    }
+    map.freeze();
+    return map;
+}
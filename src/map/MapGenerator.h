@@ -0,0 +1,13 @@
+#pragma once
+
+#include "Map.h"
+#include "../utils/Random.h"
+
+/**
+ * Generators of frozen maps for drivers and benchmarks, which need maps of a given shape or size
+ * without map files
+ */
+
+Map generateRandomMap(cris_utils::Random &rng, int maxTerritories, bool connected);
+Map generateChain(int territories, bool closed, int armies);
+Map generateGrid(int width, int height, int armies);
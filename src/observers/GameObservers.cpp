@@ -8,6 +8,7 @@
 #include "../orders/Orders.h"
 #include "../map/Map.h"
 #include "../player/PlayerStrategies.h"
+#include "../GameContext.h"
 
 using cris_utils::removeElement;
 using cris_utils::printSubtitle;
@@ -126,31 +127,33 @@ void PhaseObserver::update() {
     if (game->getCurrentPlayer() != nullptr) {
         title = title + ", " + game->getCurrentPlayer()->getName();
     }
-    printSubtitle(title);
-    cout << "Game phase overview:" << endl;
+    ostream &out = game->getContext().log();
+    printSubtitle(title, out);
+    out << "Game phase overview:" << endl;
     for (auto &player : game->getActivePlayers()) {
-        cout << player->getName() << " [" << *(player->getStrategy()) << "] : " << endl;
+        out << player->getName() << " [" << *(player->getStrategy()) << "] : " << endl;
         if (game->getPhase() == ReinforcementPhase || game->getPhase() == IssuingPhase) {
-            cout << "\tArmies: " << player->getArmies() << endl;
+            out << "\tArmies: " << player->getArmies() << endl;
         }
         if (game->getPhase() == IssuingPhase || game->getPhase() == ExecutingPhase ||
             game->getPhase() == PrepareNextRoundPhase) {
             if (player->getOwnedTerritories().size() < 8) {
-                cout << "\tTerritories:" << endl;
+                out << "\tTerritories:" << endl;
                 for (auto &territory : player->getOwnedTerritories()) {
-                    cout << "\t\t" << *territory << endl;
+                    out << "\t\t" << *territory << endl;
                 }
             }
-            cout << "\tOrders Orders:" << endl;
+            out << "\tOrders Orders:" << endl;
             for (int i = 0; i < player->getOrders()->size(); ++i) {
-                cout << "\t\t- " << *(*player->getOrders())[i] << endl;
+                out << "\t\t- " << (*player->getOrders())[i] << endl;
             }
         }
     }
+    Player *neutralPlayer = game->getContext().getNeutralPlayer();
     if (!neutralPlayer->getOwnedTerritories().empty()) {
-        cout << "Territories owned by the neutral player:" << endl;
+        out << "Territories owned by the neutral player:" << endl;
         for (auto &territory : neutralPlayer->getOwnedTerritories()) {
-            cout << "\t" << *territory << endl;
+            out << "\t" << *territory << endl;
         }
     }
 
@@ -208,8 +211,11 @@ const int BAR_WIDTH = 40;
  * Prints statistics about the current game state.
  */
 void GameStatisticsObserver::update() {
-    cout << fixed << setprecision(0);
-    printSubtitle("[GameStatisticsObserver]: World Domination Overview");
+    ostream &out = game->getContext().log();
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << fixed << setprecision(0);
+    printSubtitle("[GameStatisticsObserver]: World Domination Overview", out);
     Player *victor = nullptr;
     for (auto &player : game->getActivePlayers()) {
         double playerTerritories = player->getOwnedTerritories().size();
@@ -218,17 +224,20 @@ void GameStatisticsObserver::update() {
         int fill = BAR_WIDTH * percentage;
         int empty = BAR_WIDTH - fill;
 
-        cout << "\t- " << player->getName() << ": "
-             << string(fill, '#') << string(empty, '-') << " " << percentage * 100.0 << "%" << endl;
+        out << "\t- " << player->getName() << ": "
+            << string(fill, '#') << string(empty, '-') << " " << percentage * 100.0 << "%" << endl;
         if (percentage == 1) {
             victor = player;
         }
     }
     if (victor != nullptr) {
-        cout << victor->getName() << " has won the game!" << endl;
+        out << victor->getName() << " has won the game!" << endl;
     }
-    cout << endl;
+    out << endl;
 
+    // Leave the stream formatted the way the rest of the game expects
+    out.flags(flags);
+    out.precision(precision);
 }
 
 /**
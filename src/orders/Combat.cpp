@@ -0,0 +1,146 @@
+#include "Combat.h"
+
+#include <algorithm>
+
+#include "../map/Map.h"
+#include "../player/Player.h"
+
+using std::endl;
+using std::max;
+
+using cris_utils::Random;
+
+namespace {
+    // Each army rolls between 1 and 100, and kills an enemy army with a roll below its side's chance
+    const int ATTACK_CHANCE = 60;
+    const int DEFEND_CHANCE = 70;
+
+    /**
+     * Counts how many enemy armies are killed by rolling armies.
+     *
+     * The count follows a binomial distribution, so it is sampled directly instead of rolling
+     * once per army.
+     *
+     * @param rng generator of the game
+     * @param armies number of armies rolling
+     * @param chance rolls below this value kill
+     * @return number of kills
+     */
+    int countKills(Random &rng, int armies, int chance) {
+        return rng.binomial(armies, (chance - 1) / 100.0);
+    }
+}
+
+/**
+ * Resolves many independent battles at once
+ *
+ * Each side's kills are sampled in one draw per battle, and survivors are then computed for the
+ * whole batch in a single branch-free loop which the compiler can vectorize.
+ *
+ * @param rng generator of the game
+ * @param count number of battles
+ * @param attackers attacking armies of each battle
+ * @param defenders defending armies of each battle
+ * @param attackerSurvivors receives the attacking armies left alive
+ * @param defenderSurvivors receives the defending armies left alive
+ * @param captured receives 1 for battles where the defender was wiped out by a surviving attacker
+ */
+void resolveBattles(Random &rng, int count, const int *attackers, const int *defenders,
+                    int *attackerSurvivors, int *defenderSurvivors, uint8_t *captured) {
+    // Kills are stored in the survivor arrays until survivors are computed
+    for (int i = 0; i < count; ++i) {
+        defenderSurvivors[i] = countKills(rng, attackers[i], ATTACK_CHANCE);
+        attackerSurvivors[i] = countKills(rng, defenders[i], DEFEND_CHANCE);
+    }
+    for (int i = 0; i < count; ++i) {
+        int attacking = max(attackers[i] - attackerSurvivors[i], 0);
+        int defending = max(defenders[i] - defenderSurvivors[i], 0);
+        attackerSurvivors[i] = attacking;
+        defenderSurvivors[i] = defending;
+        captured[i] = (defending == 0) & (attacking > 0);
+    }
+}
+
+//=============================
+// CombatBatch Implementation
+//=============================
+
+CombatBatch::CombatBatch()
+        : origins{},
+          dests{},
+          attackers{},
+          defenders{},
+          attackerSurvivors{},
+          defenderSurvivors{},
+          captured{} {}
+
+ostream &operator<<(ostream &out, const CombatBatch &obj) {
+    out << "CombatBatch{ battles: " << obj.size() << " }";
+    return out;
+}
+
+/**
+ * Queues a battle. The attacking armies must already have left the origin territory.
+ *
+ * @param origin attacking territory
+ * @param attackingArmies armies used by the attacker
+ * @param dest defending territory
+ */
+void CombatBatch::add(Territory *origin, int attackingArmies, Territory *dest) {
+    origins.push_back(origin);
+    dests.push_back(dest);
+    attackers.push_back(attackingArmies);
+    defenders.push_back(dest->getArmies());
+}
+
+/**
+ * Resolves every queued battle and writes the outcomes back to the territories, in the order the
+ * battles were queued. Battles must not share territories, as they are resolved independently.
+ *
+ * @param rng generator of the game
+ * @param out stream the outcomes are narrated to
+ */
+void CombatBatch::resolve(Random &rng, ostream &out) {
+    int count = size();
+    attackerSurvivors.resize(count);
+    defenderSurvivors.resize(count);
+    captured.resize(count);
+    resolveBattles(rng, count, attackers.data(), defenders.data(),
+                   attackerSurvivors.data(), defenderSurvivors.data(), captured.data());
+
+    for (int i = 0; i < count; ++i) {
+        Territory *origin = origins[i];
+        Territory *dest = dests[i];
+        out << "Attacker kills: " << defenders[i] - defenderSurvivors[i] << endl;
+        out << "Defender kills: " << attackers[i] - attackerSurvivors[i] << endl;
+
+        dest->removeArmies(dest->getArmies() - defenderSurvivors[i]);
+        if (captured[i]) {
+            origin->getPlayer()->captureTerritory(dest);
+            dest->addArmies(attackerSurvivors[i]);
+            out << "Attack was successful! " << origin->getPlayer()->getName() << " captured "
+                << dest->getName() << endl;
+        } else {
+            origin->addArmies(attackerSurvivors[i]);
+            out << "Attack failed!" << endl;
+        }
+        out << "Attacker: " << *origin << endl;
+        out << "Defender: " << *dest << endl;
+    }
+    clear();
+}
+
+void CombatBatch::clear() {
+    origins.clear();
+    dests.clear();
+    attackers.clear();
+    defenders.clear();
+}
+
+int CombatBatch::size() const {
+    return origins.size();
+}
+
+bool CombatBatch::empty() const {
+    return origins.empty();
+}
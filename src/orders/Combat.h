@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "../utils/Random.h"
+
+using std::ostream;
+using std::vector;
+
+class Territory;
+
+void resolveBattles(cris_utils::Random &rng, int count, const int *attackers, const int *defenders,
+                    int *attackerSurvivors, int *defenderSurvivors, uint8_t *captured);
+
+/**
+ * Battles queued while executing orders, resolved all at once.
+ *
+ * Battle sizes and outcomes are stored as parallel arrays, so the outcomes of the whole batch
+ * are computed in tight loops before being written back to the territories.
+ *
+ * Note that the batch isn't responsible for the memory of the territories, so the default copy
+ * constructor, assignment operator and destructor are used
+ */
+class CombatBatch {
+private:
+    vector<Territory *> origins;
+    vector<Territory *> dests;
+    vector<int> attackers;
+    vector<int> defenders;
+    vector<int> attackerSurvivors;
+    vector<int> defenderSurvivors;
+    vector<uint8_t> captured;
+
+public:
+    CombatBatch();
+    friend ostream &operator<<(ostream &out, const CombatBatch &obj);
+
+    void add(Territory *origin, int attackingArmies, Territory *dest);
+    void resolve(cris_utils::Random &rng, ostream &out);
+    void clear();
+    int size() const;
+    bool empty() const;
+};
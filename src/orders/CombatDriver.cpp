@@ -0,0 +1,180 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "../utils/Random.h"
+
+using std::cout;
+using std::endl;
+using std::vector;
+
+using cris_utils::Random;
+
+namespace {
+    // Chances of killing an enemy army of each side, as rolled by attackTerritory
+    const int ATTACK_CHANCE = 60;
+    const int DEFEND_CHANCE = 70;
+
+    // Below this p-value, the samples are considered not to follow the binomial distribution
+    const double SIGNIFICANCE = 0.001;
+
+    /**
+     * Counts kills by rolling once per army, the way battles were resolved before kills were sampled
+     * from a binomial distribution
+     */
+    int rollKills(Random &rng, int armies, int chance) {
+        int kills = 0;
+        for (int i = 0; i < armies; ++i) {
+            if (rng.nextInt(1, 100) < chance) {
+                kills++;
+            }
+        }
+        return kills;
+    }
+
+    /**
+     * Counts kills with a single binomial draw, the way battles are resolved
+     */
+    int sampleKills(Random &rng, int armies, int chance) {
+        return rng.binomial(armies, (chance - 1) / 100.0);
+    }
+
+    /**
+     * Returns the probability of each number of kills out of a number of armies
+     */
+    vector<double> binomialPmf(int armies, double p) {
+        vector<double> pmf(armies + 1);
+        for (int k = 0; k <= armies; ++k) {
+            double logPmf = std::lgamma(armies + 1.0) - std::lgamma(k + 1.0) - std::lgamma(armies - k + 1.0)
+                            + k * std::log(p) + (armies - k) * std::log1p(-p);
+            pmf[k] = std::exp(logPmf);
+        }
+        return pmf;
+    }
+
+    /**
+     * Runs Pearson's chi-squared test of kill counts against the binomial distribution. Neighboring
+     * counts are grouped until at least 5 samples are expected in each group.
+     *
+     * @param counts number of samples with each number of kills
+     * @param pmf expected probability of each number of kills
+     * @param samples total number of samples
+     * @return the p-value of the test, from the Wilson-Hilferty approximation
+     */
+    double chiSquaredTest(const vector<long> &counts, const vector<double> &pmf, long samples) {
+        vector<double> expected;
+        vector<double> observed;
+        double groupExpected = 0;
+        double groupObserved = 0;
+        for (int k = 0; k < pmf.size(); ++k) {
+            groupExpected += pmf[k] * samples;
+            groupObserved += counts[k];
+            if (groupExpected >= 5) {
+                expected.push_back(groupExpected);
+                observed.push_back(groupObserved);
+                groupExpected = 0;
+                groupObserved = 0;
+            }
+        }
+        if (expected.empty()) {
+            return 1;
+        }
+        expected.back() += groupExpected;
+        observed.back() += groupObserved;
+
+        int degrees = expected.size() - 1;
+        if (degrees == 0) {
+            return 1;
+        }
+        double statistic = 0;
+        for (int i = 0; i < expected.size(); ++i) {
+            statistic += (observed[i] - expected[i]) * (observed[i] - expected[i]) / expected[i];
+        }
+        double scale = 2.0 / (9 * degrees);
+        double z = (std::cbrt(statistic / degrees) - (1 - scale)) / std::sqrt(scale);
+        return 0.5 * std::erfc(z / std::sqrt(2.0));
+    }
+
+    /**
+     * Draws kill counts with a given method, prints their mean, variance and fit to the binomial
+     * distribution
+     *
+     * @return whether the counts follow the binomial distribution
+     */
+    template<typename F>
+    bool checkMethod(const char *name, Random &rng, int armies, int chance, long samples, F kills) {
+        double p = (chance - 1) / 100.0;
+        vector<long> counts(armies + 1, 0);
+        double sum = 0;
+        double sumSquares = 0;
+        for (long i = 0; i < samples; ++i) {
+            int k = kills(rng, armies, chance);
+            counts[k]++;
+            sum += k;
+            sumSquares += static_cast<double>(k) * k;
+        }
+        double mean = sum / samples;
+        double variance = sumSquares / samples - mean * mean;
+        double pValue = chiSquaredTest(counts, binomialPmf(armies, p), samples);
+
+        cout << "\t" << name << ": mean " << mean << " (expected " << armies * p << "), variance " << variance
+             << " (expected " << armies * p * (1 - p) << "), chi-squared p-value " << pValue << endl;
+        return pValue >= SIGNIFICANCE;
+    }
+
+    /**
+     * Times resolving one side of many battles of a given size with a given method
+     *
+     * @return nanoseconds per battle
+     */
+    template<typename F>
+    double timeMethod(Random &rng, int armies, long battles, F kills) {
+        long sum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < battles; ++i) {
+            sum += kills(rng, armies, ATTACK_CHANCE);
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        // Keeps the draws from being optimized away
+        if (sum < 0) {
+            cout << sum;
+        }
+        return elapsed.count() / battles;
+    }
+}
+
+/**
+ * Driver for combat resolution
+ *
+ * Checks that kill counts drawn from the binomial distribution follow the same distribution as
+ * rolling once per army, for both sides and a range of army counts, then benchmarks both on large
+ * armies. Exits with 1 if either method doesn't fit the binomial distribution.
+ *
+ * Usage: Combat [samples] [seed]
+ */
+int main(int argc, char *argv[]) {
+    long samples = argc > 1 ? std::stol(argv[1]) : 20000;
+    unsigned long long seed = argc > 2 ? std::stoull(argv[2]) : 1;
+    Random rng(seed);
+
+    bool equivalent = true;
+    for (int chance : {ATTACK_CHANCE, DEFEND_CHANCE}) {
+        for (int armies : {1, 2, 5, 10, 17, 30, 100, 1000, 10000}) {
+            cout << armies << " armies, rolls below " << chance << " kill:" << endl;
+            equivalent = checkMethod("rolled per army", rng, armies, chance, samples, rollKills) && equivalent;
+            equivalent = checkMethod("binomial draw", rng, armies, chance, samples, sampleKills) && equivalent;
+        }
+    }
+    cout << (equivalent ? "Both methods follow the binomial distribution" : "A method doesn't fit the binomial distribution")
+         << endl << endl;
+
+    for (int armies : {10, 100, 1000, 10000, 100000}) {
+        long battles = std::max(100000L / armies, 100L);
+        double rolled = timeMethod(rng, armies, battles, rollKills);
+        double sampled = timeMethod(rng, armies, battles * 100, sampleKills);
+        cout << armies << " armies: " << rolled << " ns/battle rolled per army, " << sampled
+             << " ns/battle with a binomial draw (" << rolled / sampled << "x)" << endl;
+    }
+    return equivalent ? 0 : 1;
+}
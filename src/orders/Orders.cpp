@@ -1,84 +1,122 @@
 #include "Orders.h"
 
+#include <sstream>
+#include <stdexcept>
+
 #include "../player/Player.h"
 #include "../map/Map.h"
 #include "../utils/Utils.h"
+#include "../GameContext.h"
+#include "Combat.h"
 
-using std::cout;
 using std::endl;
 using std::stringstream;
-using std::to_string;
 
 using cris_utils::contains;
-using cris_utils::randInt;
-using cris_utils::removeElement;
 
 namespace {
-
-    const int ATTACK_CHANCE = 60;
-    const int DEFEND_CHANCE = 70;
-
     /**
      * Simulates an invasion attack between two territories
+     *
+     * While the game is batching combat, the battle is only queued, and resolved with the rest of
+     * the batch.
+     *
      * @param origin Attacking territory
      * @param attackingArmies armies used by attacker
      * @param dest defending territory
      */
     void attackTerritory(Territory *origin, int attackingArmies, Territory *dest) {
+        GameContext &context = origin->getPlayer()->getContext();
+        ostream &out = context.log();
         Player *attacker = origin->getPlayer();
         Player *defender = dest->getPlayer();
-        cout << attacker->getName() << " (" << origin->getName()
+        out << attacker->getName() << " (" << origin->getName()
              << ") is attacking "
              << defender->getName() << " (" << dest->getName() << ")" << endl;
         // Skip if negotiation took place
         if (contains(origin->getPlayer()->getAllies(), dest->getPlayer())) {
-            cout << origin->getPlayer()->getName() << " and " << dest->getPlayer()->getName()
+            out << origin->getPlayer()->getName() << " and " << dest->getPlayer()->getName()
                  << " are allies! Skipping attack." << endl;
             origin->addArmies(attackingArmies);
             return;
         }
-        // Calculate kills by each side
-        int attackerKills = 0;
-        int defenderKills = 0;
-        for (int i = 0; i < attackingArmies; ++i) {
-            int roll = randInt(1, 100);
-            if (roll < ATTACK_CHANCE) {
-                attackerKills++;
-            }
-        }
-
-        for (int i = 0; i < dest->getArmies(); ++i) {
-            int roll = randInt(1, 100);
-            if (roll < DEFEND_CHANCE) {
-                defenderKills++;
-            }
-        }
-        cout << "Attacker kills: " << attackerKills << endl;
-        cout << "Defender kills: " << defenderKills << endl;
-
-        dest->removeArmies(attackerKills);
-        attackingArmies -= defenderKills;
-        if (attackingArmies < 0) {
-            attackingArmies = 0;
+        if (context.getPendingBattles() != nullptr) {
+            context.getPendingBattles()->add(origin, attackingArmies, dest);
+            out << "Battle queued until the end of the turn" << endl;
+            return;
         }
-
-        if (dest->getArmies() == 0 && attackingArmies > 0) {
+        // Calculate kills by each side
+        int defendingArmies = dest->getArmies();
+        int attackerSurvivors;
+        int defenderSurvivors;
+        uint8_t captured;
+        resolveBattles(context.getRng(), 1, &attackingArmies, &defendingArmies,
+                       &attackerSurvivors, &defenderSurvivors, &captured);
+        out << "Attacker kills: " << defendingArmies - defenderSurvivors << endl;
+        out << "Defender kills: " << attackingArmies - attackerSurvivors << endl;
+
+        dest->removeArmies(defendingArmies - defenderSurvivors);
+        attackingArmies = attackerSurvivors;
+
+        if (captured) {
             // Attack successful
             origin->getPlayer()->captureTerritory(dest);
             dest->removeArmies(dest->getArmies());
             dest->addArmies(attackingArmies);
-            cout << "Attack was successful! " << origin->getPlayer()->getName() << " captured "
+            out << "Attack was successful! " << origin->getPlayer()->getName() << " captured "
                  << dest->getName() << endl;
         } else if (dest->getArmies() > 0 && attackingArmies > 0) {
             // Attack failed, origin has some armies left alive
             origin->addArmies(attackingArmies);
-            cout << "Attack failed!" << endl;
+            out << "Attack failed!" << endl;
         } else {
             // Attack failed, origin has no armies left alive, nothing additional happens
-            cout << "Attack failed!" << endl;
+            out << "Attack failed!" << endl;
+        }
+        out << "Attacker: " << *origin << endl;
+        out << "Defender: " << *dest << endl;
+    }
+
+
+    /**
+     * Returns whether a territory is one of the map's territories
+     */
+    bool isOnMap(Map *map, Territory *territory) {
+        const vector<Territory *> &territories = map->getTerritories();
+        int id = territory->getId();
+        return id >= 0 && id < territories.size() && territories[id] == territory;
+    }
+
+    // Names of the orders, indexed by OrderType
+    const char *const ORDER_NAMES[] = {
+            "DeployOrder", "AdvanceOrder", "BombOrder", "BlockadeOrder", "AirliftOrder", "NegotiateOrder",
+    };
+
+    /**
+     * Calls a function with the payload of an order, switching on the type of the order
+     *
+     * @param type type of the order
+     * @param payload variant holding the payload
+     * @param function called with the payload, as its own type
+     * @return what function returns
+     */
+    template<typename Payload, typename Function>
+    auto dispatch(OrderType type, Payload &payload, Function function) {
+        switch (type) {
+            case OrderType::DEPLOY:
+                return function(*std::get_if<DeployOrder>(&payload));
+            case OrderType::ADVANCE:
+                return function(*std::get_if<AdvanceOrder>(&payload));
+            case OrderType::BOMB:
+                return function(*std::get_if<BombOrder>(&payload));
+            case OrderType::BLOCKADE:
+                return function(*std::get_if<BlockadeOrder>(&payload));
+            case OrderType::AIRLIFT:
+                return function(*std::get_if<AirliftOrder>(&payload));
+            case OrderType::NEGOTIATE:
+            default:
+                return function(*std::get_if<NegotiateOrder>(&payload));
         }
-        cout << "Attacker: " << *origin << endl;
-        cout << "Defender: " << *dest << endl;
     }
 }
 
@@ -86,94 +124,149 @@ namespace {
 // OrdersList Implementation
 //=============================
 
-OrdersList::OrdersList() : orders{vector<Order *>()} {}
+OrdersList::OrdersList() : buckets{} {}
 
-OrdersList::OrdersList(const OrdersList &other) : orders{vector<Order *>()} {
-    for (const auto &order : other.orders) {
-        orders.push_back(order->clone());
+ostream &operator<<(ostream &out, const OrdersList &obj) {
+    out << "OrdersList{" << endl;
+    for (auto &bucket : obj.buckets) {
+        for (auto &order : bucket) {
+            out << order << endl;
+        }
     }
+    out << "}";
+    return out;
 }
 
 /**
- * Swap method. Used for the copy-and-swap idiom
- *
- * @param a first element
- * @param b second element
+ * Returns the bucket of the orders of a given type, indexed from 0 for the highest priority
  */
-void swap(OrdersList &a, OrdersList &b) {
-    using std::swap;
-    swap(a.orders, b.orders);
+int OrdersList::getPriority(OrderType type) {
+    switch (type) {
+        case OrderType::DEPLOY:
+            return 0;
+        case OrderType::AIRLIFT:
+            return 1;
+        case OrderType::BLOCKADE:
+            return 2;
+        default:
+            return 3;
+    }
 }
 
-OrdersList &OrdersList::operator=(OrdersList other) {
-    swap(*this, other);
-    return *this;
+/**
+ * Finds the bucket holding the order at a given index of the list
+ *
+ * @param i index in the list, replaced by the index in the returned bucket
+ * @return the bucket, or null if the index is out of the list
+ */
+deque<Order> *OrdersList::findBucket(int &i) {
+    if (i < 0) {
+        return nullptr;
+    }
+    for (auto &bucket : buckets) {
+        if (i < bucket.size()) {
+            return &bucket;
+        }
+        i -= bucket.size();
+    }
+    return nullptr;
 }
 
-ostream &operator<<(ostream &out, const OrdersList &obj) {
-    out << "OrdersList{" << endl;
-    for (auto order : obj.orders) {
-        out << *order << endl;
+/**
+ * Returns the order at a given index, valid until the order is removed
+ *
+ * @throws out_of_range if the index doesn't exist in the list
+ */
+Order &OrdersList::operator[](int i) {
+    deque<Order> *bucket = findBucket(i);
+    if (bucket == nullptr) {
+        throw std::out_of_range("That index doesn't exist in the list!");
     }
-    out << "}";
-    return out;
+    return (*bucket)[i];
 }
 
-Order *OrdersList::operator[](int i) {
-    return orders[i];
+const Order &OrdersList::operator[](int i) const {
+    return const_cast<OrdersList &>(*this)[i];
 }
 
 const int OrdersList::size() const {
-    return orders.size();
+    int size = 0;
+    for (auto &bucket : buckets) {
+        size += bucket.size();
+    }
+    return size;
 }
 
 const bool OrdersList::empty() const {
-    return orders.empty();
+    for (auto &bucket : buckets) {
+        if (!bucket.empty()) {
+            return false;
+        }
+    }
+    return true;
 }
 
-void OrdersList::add(Order *order) {
-    orders.push_back(order);
+void OrdersList::add(const Order &order) {
+    buckets[getPriority(order.getType())].push_back(order);
 }
 
 /**
- * Moves order from origin index to dest index
+ * Moves order from origin index to dest index. Orders can only be moved among orders of the same
+ * priority, since priorities decide the order they are executed in
  *
  * @param origin
- * @param dest
+ * @param dest index of the order to move it before, or the index after the last order of its priority
+ * to move it after every one of them
+ * @throws out_of_range if origin doesn't exist in the list, or dest is outside the orders of its priority
  */
 void OrdersList::move(int origin, int dest) {
-    if (origin < orders.size() && dest < orders.size()) {
-        int finalDest = dest > origin ? dest - 1 : dest;
-        Order *tempOrder = orders[origin];
-
-        orders.erase(orders.begin() + origin);
-        orders.insert(orders.begin() + finalDest, tempOrder);
-
-    } else {
-        cout << "INVALID INDEXES FOR MOVE" << endl;
+    int bucketStart = origin;
+    deque<Order> *bucket = findBucket(origin);
+    // Makes dest relative to the bucket, like origin
+    bucketStart -= origin;
+    dest -= bucketStart;
+    if (bucket == nullptr || dest < 0 || dest > bucket->size()) {
+        throw std::out_of_range("INVALID INDEXES FOR MOVE");
     }
+    int finalDest = dest > origin ? dest - 1 : dest;
+    Order tempOrder = (*bucket)[origin];
+
+    bucket->erase(bucket->begin() + origin);
+    bucket->insert(bucket->begin() + finalDest, tempOrder);
 }
 
 /**
  * Remove order at given index
  *
  * @param i index
+ * @throws out_of_range if the index doesn't exist in the list
  */
 void OrdersList::remove(int i) {
-    if (orders.size() <= i) {
-        cout << "That index doesn't exist in the list!" << endl;
+    deque<Order> *bucket = findBucket(i);
+    if (bucket == nullptr) {
+        throw std::out_of_range("That index doesn't exist in the list!");
     }
-    delete orders[i];
-    orders.erase(orders.begin() + i);
+    bucket->erase(bucket->begin() + i);
 }
 
 /**
- * Remove order by value
+ * Remove an order of the list, as returned by operator[] or getHighestPriorityOrder. Removing the
+ * highest priority order takes constant time
  *
  * @param order
  */
 void OrdersList::remove(Order *order) {
-    removeElement(orders, order);
+    deque<Order> &bucket = buckets[getPriority(order->getType())];
+    if (!bucket.empty() && &bucket.front() == order) {
+        bucket.pop_front();
+        return;
+    }
+    for (auto it = bucket.begin(); it != bucket.end(); ++it) {
+        if (&*it == order) {
+            bucket.erase(it);
+            return;
+        }
+    }
 }
 
 /**
@@ -183,83 +276,119 @@ void OrdersList::remove(Order *order) {
  * 3. Blockade
  * 4. Everything else
  *
- * Returns nullptr when there are no orders
+ * Orders of the same priority are returned in the order they were added. Returns nullptr when there
+ * are no orders
  *
- * @return highest priority order
+ * @return highest priority order, valid until it is removed
  */
 Order *OrdersList::getHighestPriorityOrder() {
-    vector<OrderType> priorities = {OrderType::DEPLOY, OrderType::AIRLIFT, OrderType::BLOCKADE};
-
-    for (auto &priority : priorities) {
-        for (const auto &order : orders) {
-            if (order->getType() == priority) {
-                return order;
-            }
+    for (auto &bucket : buckets) {
+        if (!bucket.empty()) {
+            return &bucket.front();
         }
     }
-
-    if (!orders.empty()) {
-        return orders[0];
-    }
-
     return nullptr;
 }
 
-OrdersList::~OrdersList() {
-    for (auto order : orders) {
-        delete order;
-    }
-    orders.clear();
+/**
+ * Returns whether the list still has deploy orders, which are executed before any other order
+ */
+bool OrdersList::hasDeployOrders() const {
+    return !buckets[getPriority(OrderType::DEPLOY)].empty();
 }
 
-
 //=============================
 // Order Implementation
 //=============================
 
-Order::Order(OrderType type)
-        : executed{false},
-          effect{""},
-          type{type} {}
+Order::Order(DeployOrder payload) : payload{payload}, executed{false} {}
+
+Order::Order(AdvanceOrder payload) : payload{payload}, executed{false} {}
+
+Order::Order(BombOrder payload) : payload{payload}, executed{false} {}
+
+Order::Order(BlockadeOrder payload) : payload{payload}, executed{false} {}
+
+Order::Order(AirliftOrder payload) : payload{payload}, executed{false} {}
+
+Order::Order(NegotiateOrder payload) : payload{payload}, executed{false} {}
 
 ostream &operator<<(ostream &out, const Order &obj) {
-    obj.print(out);
+    out << ORDER_NAMES[int(obj.getType())] << "{ "
+        << "executed: " << obj.executed;
+    if (obj.executed) {
+        out << ", effect: ";
+        dispatch(obj.getType(), obj.payload, [&out](auto &order) { order.printEffect(out); });
+    } else {
+        dispatch(obj.getType(), obj.payload, [&out](auto &order) { order.print(out); });
+    }
+    out << " }";
     return out;
 }
 
-const bool &Order::isExecuted() const {
-    return executed;
+/**
+ * Validates current Order
+ *
+ * @param map
+ * @param player
+ * @return if order is valid or not
+ */
+bool Order::validate(Map *map, Player *player) const {
+    return dispatch(getType(), payload, [map, player](auto &order) { return order.validate(map, player); });
 }
 
-const string &Order::getEffect() const {
-    return effect;
-}
+/**
+ * Executes current order, modifying the game state if needed
+ *
+ * @param map Current map
+ * @param player Player executing the order
+ */
+void Order::execute(Map *map, Player *player) {
+    ostream &out = player->getContext().log();
+    if (executed) {
+        out << *this << " was already executed. Not executing." << endl;
+        return;
+    }
+    if (!validate(map, player)) {
+        out << *this << " is invalid. Not executing." << endl;
+        return;
+    }
+    out << "Executing " << *this << endl;
 
-OrderType Order::getType() const {
-    return type;
-}
+    dispatch(getType(), payload, [map, player](auto &order) { order.execute(map, player); });
 
-void Order::setExecuted(bool executed_) {
-    executed = executed_;
+    executed = true;
+    out << "Effect: ";
+    dispatch(getType(), payload, [&out](auto &order) { order.printEffect(out); });
+    out << endl;
 }
 
-void Order::setEffect(string effect) {
-    this->effect = effect;
+bool Order::isExecuted() const {
+    return executed;
 }
 
-Order::~Order() {}
-
+OrderType Order::getType() const {
+    static_assert(std::variant_size_v<decltype(payload)> == int(OrderType::NEGOTIATE) + 1,
+                  "Every OrderType must have a payload");
+    return OrderType(payload.index());
+}
 
+/**
+ * Returns what executing the order did, or an empty string if it wasn't executed
+ */
+string Order::getEffect() const {
+    if (!executed) {
+        return "";
+    }
+    stringstream effect;
+    dispatch(getType(), payload, [&effect](auto &order) { order.printEffect(effect); });
+    return effect.str();
+}
 
 //=============================
-// DeployedOrder Implementation
+// DeployOrder Implementation
 //=============================
 
-DeployOrder::DeployOrder(int armies, Territory *territory)
-        : Order(OrderType::DEPLOY),
-          armies{armies},
-          territory{territory} {}
-
 /**
  * Validates current Order
  *
@@ -267,10 +396,10 @@ DeployOrder::DeployOrder(int armies, Territory *territory)
  * @param player
  * @return if order is valid or not
  */
-bool DeployOrder::validate(Map *map, Player *player) {
+bool DeployOrder::validate(Map *map, Player *player) const {
     // Territory must exist
     // Territory must be owned by the player
-    if (!contains(map->getTerritories(), territory)
+    if (!isOnMap(map, territory)
         || !player->owns(territory)) {
         return false;
     }
@@ -278,62 +407,36 @@ bool DeployOrder::validate(Map *map, Player *player) {
 }
 
 /**
- * Executes current order, modifying the game state if needed
+ * Executes current order. The armies were already deployed when the order was issued
  *
  * @param map Current map
  * @param player Player executing the order
  */
-void DeployOrder::execute(Map *map, Player *player) {
-    if (isExecuted()) {
-        cout << *this << " was already executed. Not executing." << endl;
-        return;
-    }
-    if (!validate(map, player)) {
-        cout << *this << " is invalid. Not executing." << endl;
-        return;
-    }
-    cout << "Executing " << *this << endl;
-
-    setEffect("Added " + to_string(armies) + " armies to territory " + territory->getName());
-
-    setExecuted(true);
-    cout << "Effect: " << getEffect() << endl;
-}
+void DeployOrder::execute(Map *map, Player *player) {}
 
 /**
- * Helper print function for polymorphic stream insertion
+ * Prints the fields of the order, for Order's stream insertion
  *
  * @param out
  */
 void DeployOrder::print(ostream &out) const {
-    out << "DeployOrder{ "
-        << "executed: " << isExecuted();
-    if (isExecuted()) {
-        out << ", effect: " << getEffect();
-    } else {
-        out << ", armies: " << armies
-            << ", territory: " << territory->getName();
-    }
-    out << " }";
+    out << ", armies: " << armies
+        << ", territory: " << territory->getName();
 }
 
 /**
- * Helper function for polymorphic cloning
+ * Describes what executing the order did
+ *
+ * @param out
  */
-DeployOrder *DeployOrder::clone() {
-    return new DeployOrder(*this);
+void DeployOrder::printEffect(ostream &out) const {
+    out << "Added " << armies << " armies to territory " << territory->getName();
 }
 
 //=============================
 // AdvanceOrder Implementation
 //=============================
 
-AdvanceOrder::AdvanceOrder(int armies, Territory *originTerr, Territory *destTerr)
-        : Order(OrderType::ADVANCE),
-          armies{armies},
-          origin{originTerr},
-          dest{destTerr} {}
-
 /**
  * Validates current Order
  *
@@ -341,13 +444,13 @@ AdvanceOrder::AdvanceOrder(int armies, Territory *originTerr, Territory *destTer
  * @param player
  * @return if order is valid or not
  */
-bool AdvanceOrder::validate(Map *map, Player *player) {
+bool AdvanceOrder::validate(Map *map, Player *player) const {
     // both territories must exist
     // Player must own origin territory
     // origin and dest territory must be adjacent
     // origin must have enough armies
-    if (!contains(map->getTerritories(), origin)
-        || !contains(map->getTerritories(), dest)
+    if (!isOnMap(map, origin)
+        || !isOnMap(map, dest)
         || !player->owns(origin)
         || !map->areAdjacent(origin, dest)
         || origin->getArmies() < armies) {
@@ -358,78 +461,53 @@ bool AdvanceOrder::validate(Map *map, Player *player) {
 }
 
 /**
- * Executes current order, modifying the game state if needed
+ * Executes current order, modifying the game state
  *
  * @param map Current map
  * @param player Player executing the order
  */
 void AdvanceOrder::execute(Map *map, Player *player) {
-    if (isExecuted()) {
-        cout << *this << " was already executed. Not executing." << endl;
-        return;
-    }
-
-    if (!validate(map, player)) {
-        cout << *this << " is invalid. Not executing." << endl;
-        return;
-    }
-    cout << "Executing " << *this << endl;
-
     origin->removeArmies(armies);
     origin->freeArmies(armies);
 
-    if (dest->getPlayer() == player) {
-        dest->addArmies(armies);
-        setEffect("Moved " + to_string(armies) + " armies from territory "
-                  + origin->getName() + " to territory " + dest->getName());
-    } else {
+    attacked = dest->getPlayer() != player;
+    if (attacked) {
         attackTerritory(origin, armies, dest);
-        setEffect("Used " + to_string(armies) + " armies from territory "
-                  + origin->getName() + " to attack territory " + dest->getName());
+    } else {
+        dest->addArmies(armies);
     }
-
-    setExecuted(true);
-    cout << "Effect: " << getEffect() << endl;
-
 }
 
 /**
- * Helper print function for polymorphic stream insertion
+ * Prints the fields of the order, for Order's stream insertion
  *
  * @param out
  */
 void AdvanceOrder::print(ostream &out) const {
-    out << "AdvanceOrder{ "
-        << "executed: " << isExecuted();
-    if (isExecuted()) {
-        out << ", effect: " << getEffect();
-    } else {
-        out << ", armies: " << armies
-            << ", origin: " << origin->getName()
-            << ", dest: " << dest->getName();
-    }
-    out << " }";
+    out << ", armies: " << armies
+        << ", origin: " << origin->getName()
+        << ", dest: " << dest->getName();
 }
 
 /**
- * Helper function for polymorphic cloning
+ * Describes what executing the order did
+ *
+ * @param out
  */
-AdvanceOrder *AdvanceOrder::clone() {
-    return new AdvanceOrder(*this);
-}
-
-Territory *AdvanceOrder::getDest() const {
-    return dest;
+void AdvanceOrder::printEffect(ostream &out) const {
+    if (attacked) {
+        out << "Used " << armies << " armies from territory " << origin->getName()
+            << " to attack territory " << dest->getName();
+    } else {
+        out << "Moved " << armies << " armies from territory " << origin->getName()
+            << " to territory " << dest->getName();
+    }
 }
 
 //=============================
 // BombOrder Implementation
 //=============================
 
-BombOrder::BombOrder(Territory *territory)
-        : Order(OrderType::BOMB),
-          territory{territory} {}
-
 /**
  * Validates current Order
  *
@@ -437,18 +515,18 @@ BombOrder::BombOrder(Territory *territory)
  * @param player
  * @return if order is valid or not
  */
-bool BombOrder::validate(Map *map, Player *player) {
+bool BombOrder::validate(Map *map, Player *player) const {
     // territory must exist
     // player can't bomb self
-    if (!contains(map->getTerritories(), territory)
+    if (!isOnMap(map, territory)
         || player->owns(territory)) {
         return false;
     }
 
     // target territory must be adjacent to one of the player's territories
     bool adjacent = false;
-    for (const auto &ownedTerritory : player->getOwnedTerritories()) {
-        if (map->areAdjacent(ownedTerritory, territory)) {
+    for (const auto &neighbor : map->getNeighbors(territory)) {
+        if (player->owns(neighbor)) {
             adjacent = true;
             break;
         }
@@ -461,61 +539,37 @@ bool BombOrder::validate(Map *map, Player *player) {
 }
 
 /**
- * Executes current order, modifying the game state if needed
+ * Executes current order, modifying the game state
  *
  * @param map Current map
  * @param player Player executing the order
  */
 void BombOrder::execute(Map *map, Player *player) {
-    if (isExecuted()) {
-        cout << *this << " was already executed. Not executing." << endl;
-        return;
-    }
-    if (!validate(map, player)) {
-        cout << *this << " is invalid. Not executing." << endl;
-        return;
-    }
-    cout << "Executing " << *this << endl;
-
     territory->bomb();
-    setEffect("Bombed territory " + territory->getName());
-
-    setExecuted(true);
-    cout << "Effect: " << getEffect() << endl;
-
 }
 
 /**
- * Helper print function for polymorphic stream insertion
+ * Prints the fields of the order, for Order's stream insertion
  *
  * @param out
  */
 void BombOrder::print(ostream &out) const {
-    out << "BombOrder{ "
-        << "executed: " << isExecuted();
-    if (isExecuted()) {
-        out << ", effect: " << getEffect();
-    } else {
-        out << ", territory: " << territory->getName();
-    }
-    out << " }";
+    out << ", territory: " << territory->getName();
 }
 
 /**
- * Helper function for polymorphic cloning
+ * Describes what executing the order did
+ *
+ * @param out
  */
-BombOrder *BombOrder::clone() {
-    return new BombOrder(*this);
+void BombOrder::printEffect(ostream &out) const {
+    out << "Bombed territory " << territory->getName();
 }
 
 //=============================
 // BlockadeOrder Implementation
 //=============================
 
-BlockadeOrder::BlockadeOrder(Territory *territory)
-        : Order(OrderType::BLOCKADE),
-          territory{territory} {}
-
 /**
  * Validates current Order
  *
@@ -523,9 +577,9 @@ BlockadeOrder::BlockadeOrder(Territory *territory)
  * @param player
  * @return if order is valid or not
  */
-bool BlockadeOrder::validate(Map *map, Player *player) {
+bool BlockadeOrder::validate(Map *map, Player *player) const {
     // territory must exist and be owned by player
-    if (!contains(map->getTerritories(), territory)
+    if (!isOnMap(map, territory)
         || !player->owns(territory)) {
         return false;
     }
@@ -534,64 +588,38 @@ bool BlockadeOrder::validate(Map *map, Player *player) {
 }
 
 /**
- * Executes current order, modifying the game state if needed
+ * Executes current order, modifying the game state
  *
  * @param map Current map
  * @param player Player executing the order
  */
 void BlockadeOrder::execute(Map *map, Player *player) {
-    if (isExecuted()) {
-        cout << *this << " was already executed. Not executing." << endl;
-        return;
-    }
-    if (!validate(map, player)) {
-        cout << *this << " is invalid. Not executing." << endl;
-        return;
-    }
-    cout << "Executing " << *this << endl;
-
     territory->blockade();
     player->loseTerritory(territory);
-    setEffect("Blockaded territory " + territory->getName());
-
-    setExecuted(true);
-    cout << "Effect: " << getEffect() << endl;
-
 }
 
 /**
- * Helper print function for polymorphic stream insertion
+ * Prints the fields of the order, for Order's stream insertion
  *
  * @param out
  */
 void BlockadeOrder::print(ostream &out) const {
-    out << "BlockadeOrder{ "
-        << "executed: " << isExecuted();
-    if (isExecuted()) {
-        out << ", effect: " << getEffect();
-    } else {
-        out << ", territory: " << territory->getName();
-    }
-    out << " }";
+    out << ", territory: " << territory->getName();
 }
 
 /**
- * Helper function for polymorphic cloning
+ * Describes what executing the order did
+ *
+ * @param out
  */
-BlockadeOrder *BlockadeOrder::clone() {
-    return new BlockadeOrder(*this);
+void BlockadeOrder::printEffect(ostream &out) const {
+    out << "Blockaded territory " << territory->getName();
 }
 
 //=============================
 // AirliftOrder Implementation
 //=============================
 
-AirliftOrder::AirliftOrder(int armies, Territory *origin, Territory *dest)
-        : Order(OrderType::AIRLIFT),
-          armies{armies},
-          origin{origin},
-          dest{dest} {}
-
 /**
  * Validates current Order
  *
@@ -599,12 +627,12 @@ AirliftOrder::AirliftOrder(int armies, Territory *origin, Territory *dest)
  * @param player
  * @return if order is valid or not
  */
-bool AirliftOrder::validate(Map *map, Player *player) {
+bool AirliftOrder::validate(Map *map, Player *player) const {
     // Both territories must exist
     // Origin territory must be owned by player
     // Origin must have enough troops to move
-    if (!contains(map->getTerritories(), origin)
-        || !contains(map->getTerritories(), dest)
+    if (!isOnMap(map, origin)
+        || !isOnMap(map, dest)
         || !player->owns(origin)
         || origin->getArmies() < armies) {
         return false;
@@ -614,73 +642,52 @@ bool AirliftOrder::validate(Map *map, Player *player) {
 }
 
 /**
- * Executes current order, modifying the game state if needed
+ * Executes current order, modifying the game state
  *
  * @param map Current map
  * @param player Player executing the order
  */
 void AirliftOrder::execute(Map *map, Player *player) {
-    if (isExecuted()) {
-        cout << *this << " was already executed. Not executing." << endl;
-        return;
-    }
-    if (!validate(map, player)) {
-        cout << *this << " is invalid. Not executing." << endl;
-        return;
-    }
-    cout << "Executing " << *this << endl;
-
     origin->removeArmies(armies);
     origin->freeArmies(armies);
 
-    if (dest->getPlayer() == player) {
-        dest->addArmies(armies);
-        setEffect("Airlift " + to_string(armies) + " armies from territory "
-                  + origin->getName() + " to territory " + dest->getName());
-    } else {
+    attacked = dest->getPlayer() != player;
+    if (attacked) {
         attackTerritory(origin, armies, dest);
-        setEffect("Airlift " + to_string(armies) + " armies from territory "
-                  + origin->getName() + " to attack territory " + dest->getName());
+    } else {
+        dest->addArmies(armies);
     }
-
-    setExecuted(true);
-    cout << "Effect: " << getEffect() << endl;
-
 }
 
 /**
- * Helper print function for polymorphic stream insertion
+ * Prints the fields of the order, for Order's stream insertion
  *
  * @param out
  */
 void AirliftOrder::print(ostream &out) const {
-    out << "AirliftOrder{ "
-        << "executed: " << isExecuted();
-    if (isExecuted()) {
-        out << ", effect: " << getEffect();
-    } else {
-        out << ", armies: " << armies
-            << ", origin: " << origin->getName()
-            << ", dest: " << dest->getName();
-    }
-    out << " }";
+    out << ", armies: " << armies
+        << ", origin: " << origin->getName()
+        << ", dest: " << dest->getName();
 }
 
 /**
- * Helper function for polymorphic cloning
+ * Describes what executing the order did
+ *
+ * @param out
  */
-AirliftOrder *AirliftOrder::clone() {
-    return new AirliftOrder(*this);
+void AirliftOrder::printEffect(ostream &out) const {
+    out << "Airlift " << armies << " armies from territory " << origin->getName();
+    if (attacked) {
+        out << " to attack territory " << dest->getName();
+    } else {
+        out << " to territory " << dest->getName();
+    }
 }
 
 //=============================
 // NegotiateOrder Implementation
 //=============================
 
-NegotiateOrder::NegotiateOrder(Player *player)
-        : Order(OrderType::NEGOTIATE),
-          player{player} {}
-
 /**
  * Validates current Order
  *
@@ -688,7 +695,7 @@ NegotiateOrder::NegotiateOrder(Player *player)
  * @param player
  * @return if order is valid or not
  */
-bool NegotiateOrder::validate(Map *map, Player *player) {
+bool NegotiateOrder::validate(Map *map, Player *player) const {
     // Player can't negotiate with themselves
     if (this->player == player) {
         return false;
@@ -697,50 +704,31 @@ bool NegotiateOrder::validate(Map *map, Player *player) {
 }
 
 /**
- * Executes current order, modifying the game state if needed
+ * Executes current order, modifying the game state
  *
  * @param map Current map
  * @param player Player executing the order
  */
 void NegotiateOrder::execute(Map *map, Player *player) {
-    if (isExecuted()) {
-        cout << *this << " was already executed. Not executing." << endl;
-        return;
-    }
-    if (!validate(map, player)) {
-        cout << *this << " is invalid. Not executing." << endl;
-        return;
-    }
-    cout << "Executing " << *this << endl;
-
     player->addAlly(this->player);
-    setEffect("Players " + this->player->getName() + " and " + player->getName()
-              + " are now allies for one turn.");
-
-    setExecuted(true);
-    cout << "Effect: " << getEffect() << endl;
-
+    issuer = player;
 }
 
 /**
- * Helper print function for polymorphic stream insertion
+ * Prints the fields of the order, for Order's stream insertion
  *
  * @param out
  */
 void NegotiateOrder::print(ostream &out) const {
-    out << "NegotiateOrder{ "
-        << "executed: " << isExecuted();
-    if (isExecuted()) {
-        out << ", effect: " << getEffect();
-    } else {
-        out << ", player: " << player->getName();
-    }
-    out << " }";
+    out << ", player: " << player->getName();
 }
 
 /**
- * Helper function for polymorphic cloning
+ * Describes what executing the order did
+ *
+ * @param out
  */
-NegotiateOrder *NegotiateOrder::clone() {
-    return new NegotiateOrder(*this);
+void NegotiateOrder::printEffect(ostream &out) const {
+    out << "Players " << player->getName() << " and " << issuer->getName()
+        << " are now allies for one turn.";
 }
@@ -1,19 +1,22 @@
 #pragma once
 
+#include <deque>
 #include <vector>
 #include <iostream>
 #include <string>
+#include <variant>
 
+using std::deque;
 using std::ostream;
 using std::string;
 using std::vector;
 using std::stringstream;
 
-class Order;
 class Territory;
 class Map;
 class Player;
 
+// Listed in the same order as the payloads of Order
 enum class OrderType {
     DEPLOY,
     ADVANCE,
@@ -24,163 +27,174 @@ enum class OrderType {
 };
 
 /**
- * Class for representing a list of orders
+ * Payload of an order for deploying troops.
+ *
+ * The armies are added to the territory when the order is issued, see Player::issueDeployOrder.
  */
-class OrdersList {
-private:
-    vector<Order *> orders;
-
-public:
-    OrdersList();
-    OrdersList(const OrdersList &other);
-    friend void swap(OrdersList &a, OrdersList &b);
-    OrdersList &operator=(OrdersList other);
-    friend ostream &operator<<(ostream &out, const OrdersList &obj);
-
-    Order *operator[](int i);
-    const int size() const;
-    const bool empty() const;
-    void add(Order *order);
-    void move(int origin, int dest);
-    void remove(int i);
-    void remove(Order *order);
-    Order *getHighestPriorityOrder();
+struct DeployOrder {
+    int armies;
+    Territory *territory;
 
-    ~OrdersList();
+    bool validate(Map *map, Player *player) const;
+    void execute(Map *map, Player *player);
+    void print(ostream &out) const;
+    void printEffect(ostream &out) const;
 };
 
-/*
- * Note that Order and its subclasses aren't responsible for managing the
- * memory of the game state. Therefore, the default copy constructor,
- * assignment operator and destructor are used, despite the presence of
- * pointer attributes
- */
 /**
- * Abstract class for player orders.
+ * Payload of an order for advancing troops
  */
-class Order {
-private:
-    bool executed;
-    string effect;
-    OrderType type;
-public:
-    Order(OrderType type);
-    friend ostream &operator<<(ostream &out, const Order &obj);
-
-    virtual bool validate(Map *map, Player *player) = 0;
-    virtual void execute(Map *map, Player *player) = 0;
-    virtual void print(ostream &out) const = 0;
-    virtual Order *clone() = 0;
+struct AdvanceOrder {
+    int armies;
+    Territory *origin;
+    Territory *dest;
+    // Whether the order attacked dest, set when it is executed
+    bool attacked = false;
 
-    const bool &isExecuted() const;
-    const string &getEffect() const;
-    OrderType getType() const;
+    bool validate(Map *map, Player *player) const;
+    void execute(Map *map, Player *player);
+    void print(ostream &out) const;
+    void printEffect(ostream &out) const;
+};
 
-    void setExecuted(bool executed);
-    void setEffect(string effect);
+/**
+ * Payload of an order for bombing territories
+ */
+struct BombOrder {
+    Territory *territory;
 
-    virtual ~Order();
+    bool validate(Map *map, Player *player) const;
+    void execute(Map *map, Player *player);
+    void print(ostream &out) const;
+    void printEffect(ostream &out) const;
 };
 
 /**
- * Order for deploying troops.
+ * Payload of an order for creating blockades
  */
-class DeployOrder : public Order {
-private:
-    int armies;
+struct BlockadeOrder {
     Territory *territory;
-public:
-    DeployOrder(int armies,
-                Territory *territory);
 
-    bool validate(Map *map, Player *player) override;
-    void execute(Map *map, Player *player) override;
-    void print(ostream &out) const override;
-    DeployOrder *clone() override;
+    bool validate(Map *map, Player *player) const;
+    void execute(Map *map, Player *player);
+    void print(ostream &out) const;
+    void printEffect(ostream &out) const;
 };
 
 /**
- * Order for advancing troops
+ * Payload of an order for moving troops to any territory
  */
-class AdvanceOrder : public Order {
-private:
+struct AirliftOrder {
     int armies;
     Territory *origin;
     Territory *dest;
-public:
-    AdvanceOrder(int armies,
-                 Territory *originTerr,
-                 Territory *destTerr);
-
-    bool validate(Map *map, Player *player) override;
-    void execute(Map *map, Player *player) override;
-    void print(ostream &out) const override;
-    AdvanceOrder *clone() override;
+    // Whether the order attacked dest, set when it is executed
+    bool attacked = false;
 
-    Territory *getDest() const;
+    bool validate(Map *map, Player *player) const;
+    void execute(Map *map, Player *player);
+    void print(ostream &out) const;
+    void printEffect(ostream &out) const;
 };
 
 /**
- * Order for bombing territories
+ * Payload of an order for negotiating with other players
  */
-class BombOrder : public Order {
-private:
-    Territory *territory;
-public:
-    BombOrder(Territory *territory);
+struct NegotiateOrder {
+    Player *player;
+    // Player who negotiated, set when the order is executed
+    Player *issuer = nullptr;
 
-    bool validate(Map *map, Player *player) override;
-    void execute(Map *map, Player *player) override;
-    void print(ostream &out) const override;
-    BombOrder *clone() override;
+    bool validate(Map *map, Player *player) const;
+    void execute(Map *map, Player *player);
+    void print(ostream &out) const;
+    void printEffect(ostream &out) const;
 };
 
 /**
- * Order for creating blockades
+ * Order issued by a player, stored by value.
+ *
+ * An order is one of the payloads above, tagged with its type, so orders are kept inline in an
+ * OrdersList and copied like plain values. validate and execute dispatch on the type with a switch.
+ * The effect of an executed order isn't stored: it is described from the payload when the order is
+ * printed.
+ *
+ * Note that orders aren't responsible for managing the memory of the game state. Therefore, the
+ * default copy constructor, assignment operator and destructor are used, despite the presence of
+ * pointer attributes
  */
-class BlockadeOrder : public Order {
+class Order {
 private:
-    Territory *territory;
+    std::variant<DeployOrder, AdvanceOrder, BombOrder, BlockadeOrder, AirliftOrder, NegotiateOrder> payload;
+    bool executed;
+
 public:
-    BlockadeOrder(Territory *territory);
+    Order(DeployOrder payload);
+    Order(AdvanceOrder payload);
+    Order(BombOrder payload);
+    Order(BlockadeOrder payload);
+    Order(AirliftOrder payload);
+    Order(NegotiateOrder payload);
+    friend ostream &operator<<(ostream &out, const Order &obj);
 
-    bool validate(Map *map, Player *player) override;
-    void execute(Map *map, Player *player) override;
-    void print(ostream &out) const override;
-    BlockadeOrder *clone() override;
-};
+    bool validate(Map *map, Player *player) const;
+    void execute(Map *map, Player *player);
 
-/**
- * Order for moving troops to any territory
- */
-class AirliftOrder : public Order {
-private:
-    int armies;
-    Territory *origin;
-    Territory *dest;
-public:
-    AirliftOrder(int armies,
-                 Territory *origin,
-                 Territory *dest);
-
-    bool validate(Map *map, Player *player) override;
-    void execute(Map *map, Player *player) override;
-    void print(ostream &out) const override;
-    AirliftOrder *clone() override;
+    bool isExecuted() const;
+    OrderType getType() const;
+    string getEffect() const;
+
+    /**
+     * Returns the payload of the order if it is of a given type, or null otherwise
+     */
+    template<typename T>
+    T *as() {
+        return std::get_if<T>(&payload);
+    }
+
+    template<typename T>
+    const T *as() const {
+        return std::get_if<T>(&payload);
+    }
 };
 
+ostream &operator<<(ostream &out, const Order &obj);
+
 /**
- * Order for negotiating with other players
+ * Class for representing a list of orders.
+ *
+ * Orders are kept by value in one FIFO bucket per priority, see getHighestPriorityOrder, so the next
+ * order to execute is always at the front of the first non-empty bucket. Finding it, removing it and
+ * checking whether deploy orders remain take constant time. Within a bucket, orders keep the order they
+ * were added in. Indices go through the buckets in priority order, which is the order the orders are
+ * executed in.
+ *
+ * Note that since this class doesn't have pointer attributes it is responsible for, the default
+ * copy constructor, assignment operator and destructor are used
  */
-class NegotiateOrder : public Order {
+class OrdersList {
 private:
-    Player *player;
+    // Deploy, airlift, blockade, then every other order
+    static constexpr int PRIORITY_COUNT = 4;
+    deque<Order> buckets[PRIORITY_COUNT];
+
+    static int getPriority(OrderType type);
+    deque<Order> *findBucket(int &i);
+
 public:
-    NegotiateOrder(Player *player);
+    OrdersList();
+    friend ostream &operator<<(ostream &out, const OrdersList &obj);
 
-    bool validate(Map *map, Player *player) override;
-    void execute(Map *map, Player *player) override;
-    void print(ostream &out) const override;
-    NegotiateOrder *clone() override;
+    Order &operator[](int i);
+    const Order &operator[](int i) const;
+    const int size() const;
+    const bool empty() const;
+    void add(const Order &order);
+    void move(int origin, int dest);
+    void remove(int i);
+    void remove(Order *order);
+    Order *getHighestPriorityOrder();
+    bool hasDeployOrders() const;
 };
 
+ostream &operator<<(ostream &out, const OrdersList &obj);
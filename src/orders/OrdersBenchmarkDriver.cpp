@@ -0,0 +1,67 @@
+#include <chrono>
+#include <iostream>
+
+#include "Orders.h"
+#include "../GameContext.h"
+#include "../map/Map.h"
+#include "../map/MapGenerator.h"
+#include "../player/Player.h"
+#include "../utils/AllocationCounter.h"
+
+using std::cout;
+using std::endl;
+
+using cris_utils::allocationCount;
+
+/**
+ * Benchmark for issuing and executing orders
+ *
+ * A player owning every territory of a ring shaped map issues deploy and advance orders each round,
+ * half of each, and executes them in priority order until their list is empty. Prints the orders issued
+ * and executed per second, and the heap allocations made per order.
+ *
+ * Usage: OrdersBenchmark [orders per round] [rounds]
+ */
+int main(int argc, char *argv[]) {
+    const int territories = 1000;
+    int ordersPerRound = argc > 1 ? std::stoi(argv[1]) : 50;
+    int rounds = argc > 2 ? std::stoi(argv[2]) : 20000;
+
+    GameContext context(nullptr, false, 1);
+    Player neutralPlayer("Neutral Player", &context);
+    context.setNeutralPlayer(&neutralPlayer);
+    Map map = generateChain(territories, true, 10);
+    Player player("Player 1", &context);
+    const vector<Territory *> &ring = map.getTerritories();
+    for (auto &territory : ring) {
+        player.captureTerritory(territory);
+    }
+    OrdersList *orders = player.getOrders();
+
+    long executed = 0;
+    long before = allocationCount();
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        player.addArmies(ordersPerRound);
+        for (int i = 0; i < ordersPerRound; ++i) {
+            int id = (round * 7 + i * 13) % territories;
+            if (i % 2 == 0) {
+                player.issueDeployOrder(ring[id], 2);
+            } else {
+                player.issueAdvanceOrder(ring[id], ring[(id + 1) % territories], 1);
+            }
+        }
+        while (!orders->empty()) {
+            Order *order = orders->getHighestPriorityOrder();
+            order->execute(&map, &player);
+            orders->remove(order);
+            executed++;
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double allocationsPerOrder = static_cast<double>(allocationCount() - before) / executed;
+
+    cout << ordersPerRound << " orders per round: " << executed / elapsed.count() / 1e6
+         << " M orders issued and executed per second, " << allocationsPerOrder << " allocations/order ("
+         << executed << " orders in " << elapsed.count() << " s)" << endl;
+}
@@ -1,3 +1,5 @@
+#include <stdexcept>
+
 #include "Orders.h"
 #include "../map/Map.h"
 #include "../player/Player.h"
@@ -35,44 +37,63 @@ int main() {
     player2->captureTerritory(t2);
 
     // You can play with these values to make them false
-    Order *deployOrder = new DeployOrder(2, t0);
-    Order *advanceOrder = new AdvanceOrder(2, t0, t1);
-    Order *bombOrder = new BombOrder(t2);
-    Order *airliftOrder = new AirliftOrder(2, t0, t1);
-    Order *negotiateOrder = new NegotiateOrder(player2);
-    Order *blockadeOrder = new BlockadeOrder(t0);
+    list.add(DeployOrder{2, t0});
+    list.add(AdvanceOrder{2, t0, t1});
+    list.add(BombOrder{t2});
+    list.add(AirliftOrder{2, t0, t1});
+    list.add(NegotiateOrder{player2});
+    list.add(BlockadeOrder{t0});
 
-    list.add(deployOrder);
-    list.add(advanceOrder);
-    list.add(bombOrder);
-    list.add(airliftOrder);
-    list.add(negotiateOrder);
-    list.add(blockadeOrder);
+    // Orders are stored in the list, by priority: deploy, airlift, blockade, then the others as they were added
+    Order &deployOrder = list[0];
+    Order &airliftOrder = list[1];
+    Order &blockadeOrder = list[2];
+    Order &advanceOrder = list[3];
+    Order &bombOrder = list[4];
+    Order &negotiateOrder = list[5];
 
-    cout << *deployOrder << " - Valid?: " << deployOrder->validate(map, player1) << endl;
-    cout << *advanceOrder << " - Valid: " << advanceOrder->validate(map, player1) << endl;
-    cout << *bombOrder << " - Valid: " << bombOrder->validate(map, player1) << endl;
-    cout << *airliftOrder << " - Valid: " << airliftOrder->validate(map, player1) << endl;
-    cout << *negotiateOrder << " - Valid: " << negotiateOrder->validate(map, player1) << endl;
-    cout << *blockadeOrder << " - Valid: " << blockadeOrder->validate(map, player1) << endl;
+    cout << deployOrder << " - Valid?: " << deployOrder.validate(map, player1) << endl;
+    cout << advanceOrder << " - Valid: " << advanceOrder.validate(map, player1) << endl;
+    cout << bombOrder << " - Valid: " << bombOrder.validate(map, player1) << endl;
+    cout << airliftOrder << " - Valid: " << airliftOrder.validate(map, player1) << endl;
+    cout << negotiateOrder << " - Valid: " << negotiateOrder.validate(map, player1) << endl;
+    cout << blockadeOrder << " - Valid: " << blockadeOrder.validate(map, player1) << endl;
 
-    deployOrder->execute(map, player1);
-    advanceOrder->execute(map, player1);
-    bombOrder->execute(map, player1);
-    airliftOrder->execute(map, player1);
-    negotiateOrder->execute(map, player1);
-    blockadeOrder->execute(map, player1);
+    deployOrder.execute(map, player1);
+    advanceOrder.execute(map, player1);
+    bombOrder.execute(map, player1);
+    airliftOrder.execute(map, player1);
+    negotiateOrder.execute(map, player1);
+    blockadeOrder.execute(map, player1);
 
     cout << endl << list << endl;
-    cout << endl << endl << *deployOrder << endl;
-    cout << *advanceOrder << endl;
-    cout << *bombOrder << endl;
-    cout << *blockadeOrder << endl;
-    cout << *airliftOrder << endl;
-    cout << *negotiateOrder << endl;
+    cout << endl << endl << deployOrder << endl;
+    cout << advanceOrder << endl;
+    cout << bombOrder << endl;
+    cout << blockadeOrder << endl;
+    cout << airliftOrder << endl;
+    cout << negotiateOrder << endl;
 
-    list.move(0, 2);
+    list.move(3, 5);
+    // The index after the last order of its priority moves an order after all of them
+    list.move(3, 6);
+    cout << endl << list << endl;
+    try {
+        list.move(3, 7);
+    } catch (const std::out_of_range &error) {
+        cout << error.what() << endl;
+    }
     list.remove(0);
+    try {
+        list.remove(10);
+    } catch (const std::out_of_range &error) {
+        cout << error.what() << endl;
+    }
+    try {
+        cout << list[10] << endl;
+    } catch (const std::out_of_range &error) {
+        cout << error.what() << endl;
+    }
 
     delete map;
     delete player1;
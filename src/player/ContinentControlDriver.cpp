@@ -0,0 +1,116 @@
+#include <iostream>
+
+#include "Player.h"
+#include "../map/Map.h"
+#include "../map/MapGenerator.h"
+#include "../GameContext.h"
+
+using std::cout;
+using std::endl;
+
+namespace {
+    // Largest random map, big enough for continents of many territories
+    const int MAX_TERRITORIES = 200;
+
+    /**
+     * Checks the continent counts of a player and the continents they control against a full scan of
+     * the map, describing the first difference found
+     *
+     * @return whether the incremental counts match the scan
+     */
+    bool checkPlayer(Map &map, Player *player) {
+        const vector<Continent *> &continents = map.getContinents();
+        vector<int> owned(continents.size(), 0);
+        vector<int> total(continents.size(), 0);
+        for (auto &territory : map.getTerritories()) {
+            int continentId = territory->getContinent()->getId();
+            total[continentId]++;
+            owned[continentId] += territory->getPlayer() == player ? 1 : 0;
+        }
+
+        set<Continent *> controlled = map.getContinentsControlledByPlayer(player);
+        for (auto &continent : continents) {
+            int id = continent->getId();
+            if (player->getTerritoryCount(continent) != owned[id]) {
+                cout << player->getName() << " owns " << owned[id] << " territories of " << continent->getName()
+                     << " but counts " << player->getTerritoryCount(continent) << endl;
+                return false;
+            }
+            if ((controlled.count(continent) == 1) != (owned[id] == total[id])) {
+                cout << player->getName() << " owns " << owned[id] << "/" << total[id] << " territories of "
+                     << continent->getName() << " but control is reported as " << (controlled.count(continent) == 1)
+                     << endl;
+                return false;
+            }
+        }
+
+        if (player->getOwnedMask().count() != player->getOwnedTerritories().size()) {
+            cout << player->getName() << " has " << player->getOwnedTerritories().size()
+                 << " owned territories but " << player->getOwnedMask().count() << " in their mask" << endl;
+            return false;
+        }
+        return true;
+    }
+}
+
+/**
+ * Driver checking the continent counts kept by Player against a full recount
+ *
+ * Plays random captures and losses of territories on random maps, and after each one compares the
+ * number of territories each player owns per continent, and the continents they control, with what a
+ * scan of every territory finds.
+ *
+ * Usage: ContinentControl [maps] [seed]
+ */
+int main(int argc, char *argv[]) {
+    cout << std::boolalpha;
+
+    int numMaps = argc > 1 ? std::stoi(argv[1]) : 200;
+    unsigned long long seed = argc > 2 ? std::stoull(argv[2]) : 1;
+    cris_utils::Random rng(seed);
+
+    long checks = 0;
+    for (int m = 0; m < numMaps; ++m) {
+        Map map = generateRandomMap(rng, MAX_TERRITORIES, false);
+        const vector<Territory *> &territories = map.getTerritories();
+
+        GameContext context(nullptr, false, rng.next());
+        Player neutralPlayer("Neutral Player", &context);
+        context.setNeutralPlayer(&neutralPlayer);
+        vector<Player *> players;
+        int numPlayers = rng.nextInt(2, 5);
+        for (int i = 0; i < numPlayers; ++i) {
+            players.push_back(new Player("Player " + std::to_string(i + 1), &context));
+        }
+        players.push_back(&neutralPlayer);
+
+        int steps = rng.nextInt(1, 4) * territories.size();
+        bool valid = true;
+        for (int step = 0; valid && step < steps; ++step) {
+            Territory *territory = territories[rng.nextInt(0, territories.size() - 1)];
+            Player *player = players[rng.nextInt(0, numPlayers - 1)];
+            if (territory->getPlayer() != nullptr && rng.nextInt(0, 3) == 0) {
+                territory->getPlayer()->loseTerritory(territory);
+            } else {
+                player->captureTerritory(territory);
+            }
+
+            for (auto &checked : players) {
+                valid = valid && checkPlayer(map, checked);
+                checks++;
+            }
+        }
+
+        for (int i = 0; i < numPlayers; ++i) {
+            delete players[i];
+        }
+        if (!valid) {
+            cout << "Map " << m << " (seed " << seed << "): continent counts don't match a full recount" << endl;
+            return 1;
+        }
+    }
+
+    cout << "Continent counts matched a full recount in " << checks << " checks over " << numMaps << " maps"
+         << endl;
+    return 0;
+}
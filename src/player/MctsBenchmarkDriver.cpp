@@ -0,0 +1,109 @@
+#include <iostream>
+
+#include "MctsPlayerStrategy.h"
+#include "Player.h"
+#include "PlayerStrategies.h"
+#include "../GameEngine.h"
+
+using std::cout;
+using std::endl;
+
+namespace {
+    /**
+     * Results of the MCTS player over the games against one opponent
+     */
+    struct MatchRecord {
+        int games = 0;
+        int wins = 0;
+        int draws = 0;
+        long long rollouts = 0;
+        double searchSeconds = 0;
+    };
+
+    /**
+     * Plays seeded games of an MCTS player against an opponent, and adds up its wins and search
+     * statistics. The players' order is randomized by the game, so the MCTS player is found by its strategy.
+     *
+     * @param config configuration of every game, whose seed and strategies are replaced
+     * @return false if a game couldn't be set up
+     */
+    bool playMatch(GameConfig config, const StrategyFactory &opponent, int games, MatchRecord &record) {
+        config.strategies = {
+                [](Player *player) { return new MctsPlayerStrategy(player); },
+                opponent
+        };
+        for (int seed = 1; seed <= games; ++seed) {
+            config.seed = seed;
+            Game game;
+            if (!game.gameStart(config)) {
+                return false;
+            }
+            game.startupPhase();
+            game.mainGameLoop();
+
+            for (auto &player : game.getPlayers()) {
+                auto *mcts = dynamic_cast<MctsPlayerStrategy *>(player->getStrategy());
+                if (mcts == nullptr) {
+                    continue;
+                }
+                record.rollouts += mcts->getRollouts();
+                record.searchSeconds += mcts->getSearchSeconds();
+                if (game.getWinner() == player) {
+                    record.wins++;
+                }
+            }
+            if (game.getWinner() == nullptr) {
+                record.draws++;
+            }
+            record.games++;
+        }
+        return true;
+    }
+
+    /**
+     * Prints the playouts per second and the win rate of the MCTS player against an opponent
+     */
+    void printMatch(const string &opponent, const MatchRecord &record) {
+        double rolloutsPerSecond = record.searchSeconds > 0 ? record.rollouts / record.searchSeconds : 0;
+        cout << "MCTS vs " << opponent << ": " << rolloutsPerSecond << " rollouts/s (" << record.rollouts
+             << " in " << record.searchSeconds << " s), won " << record.wins << "/" << record.games
+             << " (" << 100.0 * record.wins / record.games << "%), " << record.draws << " draws" << endl;
+    }
+}
+
+/**
+ * Benchmark for the MCTS strategy
+ *
+ * Plays seeded games of an MCTS player with the default search budget against an aggressive player,
+ * then against a benevolent one, and prints the playouts per second spent searching and the win rate
+ * against each. Games still running after the maximum number of rounds are draws.
+ *
+ * Usage: MctsBenchmark [map file] [warzone|conquest] [games] [max rounds]
+ * The map defaults to maps/zertina/zertina.map, from the root of the repository.
+ */
+int main(int argc, char *argv[]) {
+    GameConfig config;
+    config.mapPath = argc > 1 ? argv[1] : "maps/zertina/zertina.map";
+    string format = argc > 2 ? argv[2] : "warzone";
+    int games = argc > 3 ? std::stoi(argv[3]) : 10;
+    config.maxRounds = argc > 4 ? std::stoi(argv[4]) : 50;
+    if ((format != "warzone" && format != "conquest") || games <= 0) {
+        cout << "Usage: " << argv[0] << " [map file] [warzone|conquest] [games] [max rounds]" << endl;
+        return 1;
+    }
+    config.mapFormat = format == "conquest" ? MapFormat::Conquest : MapFormat::WarZone;
+
+    MatchRecord aggressive;
+    MatchRecord benevolent;
+    if (!playMatch(config, [](Player *player) { return new AggressivePlayerStrategy(player); }, games, aggressive)
+        || !playMatch(config, [](Player *player) { return new BenevolentPlayerStrategy(player); }, games,
+                      benevolent)) {
+        cout << "Can't load " << config.mapPath << endl;
+        return 1;
+    }
+    cout << config.mapPath << ": " << games << " games against each opponent, at most " << config.maxRounds
+         << " rounds" << endl;
+    printMatch("Aggressive", aggressive);
+    printMatch("Benevolent", benevolent);
+    return 0;
+}
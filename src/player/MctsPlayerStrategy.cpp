@@ -0,0 +1,945 @@
+#include "MctsPlayerStrategy.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+#include "Player.h"
+#include "../cards/Cards.h"
+#include "../map/Map.h"
+#include "../orders/Combat.h"
+#include "../orders/Orders.h"
+#include "../GameContext.h"
+#include "../GameState.h"
+#include "../MoveLog.h"
+#include "../utils/Random.h"
+
+using std::endl;
+using std::max;
+
+using cris_utils::Random;
+using cris_utils::Span;
+using cris_utils::ThreadPool;
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    // Orders issued after deploying, beyond which the strategy ends its turn
+    const int MAX_ORDERS_PER_TURN = 6;
+    // Attacks made by each player on each turn of a rollout
+    const int ROLLOUT_ATTACKS = 3;
+    // Armies given by a reinforcement card
+    const int REINFORCEMENT_CARD_ARMIES = 5;
+    // Score lost for every round a rollout takes to win, so quicker wins are preferred
+    const double WIN_DELAY_PENALTY = 0.01;
+
+    enum class ActionType {
+        DEPLOY,
+        ATTACK,
+        BOMB,
+        REINFORCE,
+        AIRLIFT,
+        BLOCKADE,
+        STOP,
+    };
+
+    /**
+     * Candidate order, referring to territories by id
+     */
+    struct Action {
+        ActionType type;
+        int origin;
+        int dest;
+        int armies;
+
+        bool operator==(const Action &other) const {
+            return type == other.type && origin == other.origin && dest == other.dest;
+        }
+    };
+
+    /**
+     * Layout of the map, copied into flat arrays once per decision so rollouts don't touch the map
+     */
+    struct Topology {
+        // Neighbors in compressed sparse row form, like in Map
+        vector<int> offsets;
+        vector<int> neighbors;
+        // Continent id of each territory, -1 when the territory isn't part of the map's continents
+        vector<int> continentOf;
+        vector<int> continentBonus;
+        vector<int> continentSize;
+    };
+
+    /**
+     * Node of the search tree, reached by playing an action from its parent.
+     *
+     * Below the root, the tree is open-loop: a node stands for a sequence of actions rather than for a
+     * position, since battles are random and the same actions lead to different positions on every
+     * playout. The actions available are found again from the position of each playout.
+     */
+    struct Node {
+        Action action;
+        vector<int> children;
+        double reward;
+        int visits;
+        // Playouts going through the node which haven't been scored yet. They count as losses, so other
+        // threads spread over the rest of the tree instead of all following the same path
+        int virtualLoss;
+    };
+
+    /**
+     * Search tree shared by every thread searching for a decision. Nodes are indexed by their position
+     * in the list, the root being node 0
+     */
+    struct Tree {
+        std::mutex mutex;
+        vector<Node> nodes;
+        // Playouts started so far, across every thread
+        long long playouts = 0;
+    };
+
+    /**
+     * Position reached by a playout, with the round it is at and what the searching player is doing
+     */
+    struct Playout {
+        GameState state;
+        // Round being simulated, 0 being the current round of the game
+        int round;
+        // Whether the searching player has armies to deploy before issuing other orders
+        bool deploying;
+        int reinforcements;
+        // Orders issued by the searching player in the current round, deploys excepted
+        int orders;
+        bool finished;
+        double reward;
+    };
+
+    Topology buildTopology(Map *map) {
+        map->freeze();
+        Topology topology;
+        const vector<Territory *> &territories = map->getTerritories();
+        const vector<Continent *> &continents = map->getContinents();
+
+        topology.offsets.push_back(0);
+        for (auto &territory : territories) {
+            for (int neighborId : map->neighbors(territory->getId())) {
+                topology.neighbors.push_back(neighborId);
+            }
+            topology.offsets.push_back(topology.neighbors.size());
+
+            int continentId = territory->getContinent()->getId();
+            bool known = continentId >= 0 && continentId < continents.size()
+                         && continents[continentId] == territory->getContinent();
+            topology.continentOf.push_back(known ? continentId : -1);
+        }
+        for (auto &continent : continents) {
+            topology.continentBonus.push_back(continent->getArmies());
+            topology.continentSize.push_back(map->getTerritoriesByContinent(continent).size());
+        }
+        return topology;
+    }
+
+    /**
+     * Returns whether a territory has a neighbor owned by someone else
+     */
+    bool isFrontier(const GameState &state, const Topology &topology, int territory) {
+        int owner = state.getOwner(territory);
+        for (int i = topology.offsets[territory]; i < topology.offsets[territory + 1]; ++i) {
+            if (state.getOwner(topology.neighbors[i]) != owner) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Armies a player receives at the start of a round, following Game::reinforcementPhase
+     */
+    int reinforcementsFor(const GameState &state, const Topology &topology, int player, vector<int> &counts) {
+        counts.assign(topology.continentBonus.size(), 0);
+        int owned = 0;
+        Span<int32_t> owners = state.getAllOwners();
+        for (int i = 0; i < owners.size(); ++i) {
+            if (owners[i] == player) {
+                owned++;
+                if (topology.continentOf[i] >= 0) {
+                    counts[topology.continentOf[i]]++;
+                }
+            }
+        }
+        int armies = owned / 3;
+        for (int c = 0; c < counts.size(); ++c) {
+            if (counts[c] == topology.continentSize[c]) {
+                armies += topology.continentBonus[c];
+            }
+        }
+        return armies;
+    }
+
+    /**
+     * Attacks a territory, moving the surviving attackers in if it is captured
+     */
+    void fight(GameState &state, Random &rng, int origin, int armies, int dest) {
+        int defenders = state.getArmies(dest);
+        int attackerSurvivors;
+        int defenderSurvivors;
+        uint8_t captured;
+        state.setArmies(origin, state.getArmies(origin) - armies);
+        resolveBattles(rng, 1, &armies, &defenders, &attackerSurvivors, &defenderSurvivors, &captured);
+        if (captured) {
+            state.setOwner(dest, state.getOwner(origin));
+            state.setArmies(dest, attackerSurvivors);
+        } else {
+            state.setArmies(dest, defenderSurvivors);
+            state.setArmies(origin, state.getArmies(origin) + attackerSurvivors);
+        }
+    }
+
+    /**
+     * Plays a random turn for a player: deploys to a random frontier territory, then attacks weaker
+     * neighbors from random frontier territories
+     */
+    void playRandomTurn(GameState &state, const Topology &topology, int player, int reinforcements,
+                        Random &rng, vector<int> &frontier) {
+        frontier.clear();
+        for (int i = 0; i < state.getTerritoryCount(); ++i) {
+            if (state.getOwner(i) == player && isFrontier(state, topology, i)) {
+                frontier.push_back(i);
+            }
+        }
+        if (frontier.empty()) {
+            return;
+        }
+
+        int deployed = frontier[rng.nextInt(0, frontier.size() - 1)];
+        state.setArmies(deployed, state.getArmies(deployed) + reinforcements);
+
+        for (int attack = 0; attack < ROLLOUT_ATTACKS; ++attack) {
+            int origin = frontier[rng.nextInt(0, frontier.size() - 1)];
+            int degree = topology.offsets[origin + 1] - topology.offsets[origin];
+            if (state.getOwner(origin) != player || state.getArmies(origin) == 0 || degree == 0) {
+                continue;
+            }
+            int dest = topology.neighbors[topology.offsets[origin] + rng.nextInt(0, degree - 1)];
+            if (state.getOwner(dest) != player && state.getArmies(origin) > state.getArmies(dest)) {
+                fight(state, rng, origin, state.getArmies(origin), dest);
+            }
+        }
+    }
+
+    /**
+     * Scores a position for a player, between 0 when eliminated and 1 when owning the whole map
+     */
+    double score(const GameState &state, int player) {
+        int owned = state.countOwned(player);
+        if (owned == 0 || owned == state.getTerritoryCount()) {
+            return owned == 0 ? 0 : 1;
+        }
+        long long armies = 0;
+        long long allArmies = 0;
+        Span<int32_t> owners = state.getAllOwners();
+        Span<int32_t> territoryArmies = state.getAllArmies();
+        for (int i = 0; i < owners.size(); ++i) {
+            allArmies += territoryArmies[i];
+            if (owners[i] == player) {
+                armies += territoryArmies[i];
+            }
+        }
+        double territoryShare = static_cast<double>(owned) / state.getTerritoryCount();
+        double armyShare = allArmies == 0 ? 0 : static_cast<double>(armies) / allArmies;
+        return 0.5 * territoryShare + 0.5 * armyShare;
+    }
+
+    /**
+     * Returns whether the territories of a player decide the playout, and if so, records its reward.
+     * Wins are rewarded less the more rounds they take
+     */
+    bool checkDecided(Playout &playout, int player) {
+        int owned = playout.state.countOwned(player);
+        if (owned == playout.state.getTerritoryCount()) {
+            playout.finished = true;
+            playout.reward = 1 - WIN_DELAY_PENALTY * (playout.round + 1);
+        } else if (owned == 0) {
+            playout.finished = true;
+            playout.reward = 0;
+        }
+        return playout.finished;
+    }
+
+    /**
+     * Ends the searching player's turn: the other players play random turns until it is the searching
+     * player's turn again, on the next round.
+     *
+     * On the current round, the other players only deploy what they have left, since they were
+     * already reinforced, and then play the whole next round before the searching player does.
+     */
+    void endTurn(Playout &playout, const Topology &topology, int player, int rounds, Random &rng,
+                 vector<int> &scratch) {
+        int players = playout.state.getPlayerCount();
+        int last = playout.round + 1;
+        for (int nextRound = playout.round == 0 ? 0 : last; nextRound <= last; ++nextRound) {
+            playout.round = nextRound;
+            if (nextRound >= rounds) {
+                playout.finished = true;
+                playout.reward = score(playout.state, player);
+                return;
+            }
+            for (int i = 1; i < players; ++i) {
+                int current = (player + i) % players;
+                int reinforcements = nextRound == 0
+                                     ? playout.state.getReinforcements(current)
+                                     : reinforcementsFor(playout.state, topology, current, scratch);
+                playRandomTurn(playout.state, topology, current, reinforcements, rng, scratch);
+            }
+            if (checkDecided(playout, player)) {
+                return;
+            }
+        }
+        playout.deploying = true;
+        playout.reinforcements = reinforcementsFor(playout.state, topology, player, scratch);
+        playout.orders = 0;
+    }
+
+    /**
+     * Lists the actions the searching player may play in a playout: deploying their reinforcements to
+     * a frontier territory at the start of their turn, then attacking weaker neighbors with every army
+     * of a territory, or ending their turn
+     */
+    void playoutActions(const Playout &playout, const Topology &topology, int player, vector<Action> &actions) {
+        actions.clear();
+        const GameState &state = playout.state;
+        for (int i = 0; i < state.getTerritoryCount(); ++i) {
+            if (state.getOwner(i) != player || !isFrontier(state, topology, i)) {
+                continue;
+            }
+            if (playout.deploying) {
+                actions.push_back({ActionType::DEPLOY, -1, i, playout.reinforcements});
+                continue;
+            }
+            if (playout.orders >= MAX_ORDERS_PER_TURN) {
+                break;
+            }
+            for (int n = topology.offsets[i]; n < topology.offsets[i + 1]; ++n) {
+                int neighbor = topology.neighbors[n];
+                if (state.getOwner(neighbor) != player && state.getArmies(i) > state.getArmies(neighbor)) {
+                    actions.push_back({ActionType::ATTACK, i, neighbor, 0});
+                }
+            }
+        }
+        if (!playout.deploying) {
+            actions.push_back({ActionType::STOP, -1, -1, 0});
+        }
+    }
+
+    /**
+     * Plays an action of the searching player in a playout
+     */
+    void playAction(Playout &playout, const Action &action, const Topology &topology, int player, int rounds,
+                    Random &rng, vector<int> &scratch) {
+        GameState &state = playout.state;
+        switch (action.type) {
+            case ActionType::DEPLOY:
+                state.setArmies(action.dest, state.getArmies(action.dest) + action.armies);
+                playout.deploying = false;
+                break;
+            case ActionType::ATTACK:
+                fight(state, rng, action.origin, state.getArmies(action.origin), action.dest);
+                playout.orders++;
+                checkDecided(playout, player);
+                break;
+            case ActionType::STOP:
+                endTurn(playout, topology, player, rounds, rng, scratch);
+                break;
+            default:
+                // Cards are only played at the root, where their effect is part of the child's position
+                break;
+        }
+    }
+
+    /**
+     * Plays random turns from a position until the playout is decided or runs out of rounds. The rest of
+     * the searching player's current turn is skipped, except for deploying their reinforcements.
+     */
+    void rollout(Playout &playout, const Topology &topology, int player, int rounds, Random &rng,
+                 vector<int> &scratch) {
+        while (!playout.finished) {
+            if (playout.deploying) {
+                playRandomTurn(playout.state, topology, player, playout.reinforcements, rng, scratch);
+                playout.deploying = false;
+                if (checkDecided(playout, player)) {
+                    return;
+                }
+            }
+            endTurn(playout, topology, player, rounds, rng, scratch);
+        }
+    }
+
+    /**
+     * Returns the UCT value of a child, with its pending playouts counted as losses. Children which
+     * were never visited come first
+     */
+    double uct(const Node &child, int parentVisits, double exploration) {
+        int visits = child.visits + child.virtualLoss;
+        if (visits == 0) {
+            return std::numeric_limits<double>::infinity();
+        }
+        return child.reward / visits + exploration * std::sqrt(std::log(parentVisits) / visits);
+    }
+
+    /**
+     * Picks the child of a node to play next among the actions available, adding a child for the first
+     * available action which has none yet. Must be called with the tree locked
+     *
+     * @param expanded set to whether a child was added
+     * @return index of the child
+     */
+    int selectChild(Tree &tree, int node, const vector<Action> &available, double exploration, bool &expanded) {
+        expanded = false;
+        int best = -1;
+        double bestValue = -1;
+        int parentVisits = max(tree.nodes[node].visits + tree.nodes[node].virtualLoss, 1);
+        for (auto &action : available) {
+            int found = -1;
+            for (int child : tree.nodes[node].children) {
+                if (tree.nodes[child].action == action) {
+                    found = child;
+                    break;
+                }
+            }
+            if (found == -1) {
+                tree.nodes.push_back({action, {}, 0, 0, 0});
+                int child = tree.nodes.size() - 1;
+                tree.nodes[node].children.push_back(child);
+                expanded = true;
+                return child;
+            }
+            double value = uct(tree.nodes[found], parentVisits, exploration);
+            if (value > bestValue) {
+                bestValue = value;
+                best = found;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * Runs playouts on a search tree shared with other threads, until the budget is spent.
+     *
+     * Each playout selects actions down the tree with UCT, adds one node, plays the rest of the game
+     * randomly, and adds its score to every node on its path. The tree is only locked to select and to
+     * update nodes, so playouts of different threads are simulated at the same time. Nodes on the path
+     * of a playout carry a virtual loss until it is scored.
+     *
+     * @param children position after each action of the root. Attacks of the root are fought on
+     * every playout
+     * @param actions actions of the root, the children of node 0
+     * @param issued orders the player issued this round before the decision, deploys excepted
+     * @param playouts playouts to run over every thread. No limit when 0
+     * @param deadline time after which the search stops, when limited
+     */
+    void search(Tree &tree, const vector<GameState> &children, const vector<Action> &actions,
+                const Topology &topology, int player, int issued, const MctsConfig &config, long long playouts,
+                bool timed, Clock::time_point deadline, uint64_t seed) {
+        Random rng(seed);
+        vector<int> scratch;
+        vector<Action> available;
+        vector<int> path;
+
+        while (true) {
+            path.assign(1, 0);
+            int node = 0;
+            bool expanded = false;
+            {
+                std::lock_guard<std::mutex> lock(tree.mutex);
+                if ((playouts > 0 && tree.playouts >= playouts) || (timed && Clock::now() >= deadline)) {
+                    return;
+                }
+                tree.playouts++;
+                tree.nodes[0].virtualLoss++;
+                node = selectChild(tree, 0, actions, config.exploration, expanded);
+                tree.nodes[node].virtualLoss++;
+            }
+            path.push_back(node);
+
+            // Root actions were made on the game itself, so their position is already known
+            const Action &rootAction = actions[node - 1];
+            Playout playout{children[node - 1], 0, false, 0, issued, false, 0};
+            if (rootAction.type != ActionType::DEPLOY && rootAction.type != ActionType::STOP) {
+                playout.orders++;
+            }
+            if (rootAction.type == ActionType::ATTACK) {
+                fight(playout.state, rng, rootAction.origin, rootAction.armies, rootAction.dest);
+                checkDecided(playout, player);
+            } else if (rootAction.type == ActionType::STOP) {
+                endTurn(playout, topology, player, config.rolloutRounds, rng, scratch);
+            }
+
+            while (!playout.finished && !expanded) {
+                playoutActions(playout, topology, player, available);
+                if (available.empty()) {
+                    // Nowhere to deploy: the reinforcements are lost, like in a random turn
+                    playout.deploying = false;
+                    continue;
+                }
+                Action action;
+                {
+                    std::lock_guard<std::mutex> lock(tree.mutex);
+                    node = selectChild(tree, node, available, config.exploration, expanded);
+                    tree.nodes[node].virtualLoss++;
+                    action = tree.nodes[node].action;
+                }
+                path.push_back(node);
+                playAction(playout, action, topology, player, config.rolloutRounds, rng, scratch);
+            }
+            rollout(playout, topology, player, config.rolloutRounds, rng, scratch);
+
+            std::lock_guard<std::mutex> lock(tree.mutex);
+            for (int visited : path) {
+                tree.nodes[visited].visits++;
+                tree.nodes[visited].reward += playout.reward;
+                tree.nodes[visited].virtualLoss--;
+            }
+        }
+    }
+
+    /**
+     * Finds the first card of a given type in a hand
+     */
+    template<typename T>
+    T *findCard(Hand *hand) {
+        for (auto &card : hand->getCards()) {
+            if (auto found = dynamic_cast<T *>(card)) {
+                return found;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Returns whether one of the player's advance orders already targets a territory
+     */
+    bool alreadyTargeted(Player *player, Territory *territory) {
+        OrdersList *orders = player->getOrders();
+        for (int i = 0; i < orders->size(); ++i) {
+            auto advance = (*orders)[i].as<AdvanceOrder>();
+            if (advance != nullptr && advance->dest == territory) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Counts the orders the player issued this round, deploys excepted
+     */
+    int countIssuedOrders(Player *player) {
+        int issued = 0;
+        for (int i = 0; i < player->getOrders()->size(); ++i) {
+            if ((*player->getOrders())[i].getType() != OrderType::DEPLOY) {
+                issued++;
+            }
+        }
+        return issued;
+    }
+
+    /**
+     * Lists the orders the player may issue next.
+     *
+     * Diplomacy cards are never played: playouts don't model truces, so a negotiation would always
+     * look like a wasted order.
+     */
+    vector<Action> candidateActions(Player *player, Map *map) {
+        vector<Action> actions;
+        vector<Territory *> frontier;
+        for (auto &territory : player->getOwnedTerritories()) {
+            if (territory->canAttack(map)) {
+                frontier.push_back(territory);
+            }
+        }
+        std::sort(frontier.begin(), frontier.end(), [](Territory *t1, Territory *t2) {
+            return t1->getId() < t2->getId();
+        });
+
+        if (player->getArmies() > 0) {
+            for (auto &territory : frontier) {
+                actions.push_back({ActionType::DEPLOY, -1, territory->getId(), player->getArmies()});
+            }
+            if (actions.empty()) {
+                Territory *any = *player->getOwnedTerritories().begin();
+                actions.push_back({ActionType::DEPLOY, -1, any->getId(), player->getArmies()});
+            }
+            return actions;
+        }
+
+        if (countIssuedOrders(player) >= MAX_ORDERS_PER_TURN) {
+            actions.push_back({ActionType::STOP, -1, -1, 0});
+            return actions;
+        }
+
+        for (auto &origin : frontier) {
+            if (origin->getAvailableArmies() == 0) {
+                continue;
+            }
+            for (auto &neighbor : map->getNeighbors(origin)) {
+                if (neighbor->getPlayer() != player && !alreadyTargeted(player, neighbor)) {
+                    actions.push_back({ActionType::ATTACK, origin->getId(), neighbor->getId(),
+                                       origin->getAvailableArmies()});
+                }
+            }
+        }
+        if (findCard<BombCard>(player->getHand()) != nullptr) {
+            for (auto &enemy : player->getNeighboringTerritories(map)) {
+                actions.push_back({ActionType::BOMB, -1, enemy->getId(), 0});
+            }
+        }
+        if (findCard<ReinforcementCard>(player->getHand()) != nullptr) {
+            for (auto &territory : frontier) {
+                actions.push_back({ActionType::REINFORCE, -1, territory->getId(), REINFORCEMENT_CARD_ARMIES});
+            }
+        }
+        if (findCard<AirliftCard>(player->getHand()) != nullptr) {
+            // Flies the armies of the territory with the most to spare to one of the frontier territories
+            Territory *origin = nullptr;
+            for (auto &territory : player->getOwnedTerritories()) {
+                if (territory->getAvailableArmies() > 0
+                    && (origin == nullptr || territory->getAvailableArmies() > origin->getAvailableArmies()
+                        || (territory->getAvailableArmies() == origin->getAvailableArmies()
+                            && territory->getId() < origin->getId()))) {
+                    origin = territory;
+                }
+            }
+            for (auto &territory : frontier) {
+                if (origin != nullptr && territory != origin) {
+                    actions.push_back({ActionType::AIRLIFT, origin->getId(), territory->getId(),
+                                       origin->getAvailableArmies()});
+                }
+            }
+        }
+        if (findCard<BlockadeCard>(player->getHand()) != nullptr) {
+            for (auto &territory : frontier) {
+                actions.push_back({ActionType::BLOCKADE, -1, territory->getId(), 0});
+            }
+        }
+        // Last, so orders are preferred when they look as good as ending the turn
+        actions.push_back({ActionType::STOP, -1, -1, 0});
+        return actions;
+    }
+
+    /**
+     * Makes the changes of an action to the game itself, the way the order would. Attacks are left to
+     * the search, since their outcome is random
+     */
+    void makeAction(Player *player, Map *map, const Action &action) {
+        Territory *dest = action.dest >= 0 ? map->getTerritories()[action.dest] : nullptr;
+        switch (action.type) {
+            case ActionType::DEPLOY:
+                player->removeArmies(action.armies);
+                dest->addArmies(action.armies);
+                break;
+            case ActionType::BOMB:
+                dest->bomb();
+                break;
+            case ActionType::REINFORCE:
+                dest->addArmies(action.armies);
+                break;
+            case ActionType::AIRLIFT:
+                map->getTerritories()[action.origin]->reserveArmies(action.armies);
+                break;
+            case ActionType::ATTACK:
+            case ActionType::BLOCKADE:
+            case ActionType::STOP:
+                break;
+        }
+    }
+
+    /**
+     * Adds the effect of an order executed later in the round to the position after the action. Attacks
+     * are left to the search, since their outcome is random
+     */
+    void applyToSnapshot(GameState &state, const Action &action) {
+        switch (action.type) {
+            case ActionType::AIRLIFT:
+                state.setArmies(action.dest, state.getArmies(action.dest) + action.armies);
+                break;
+            case ActionType::BLOCKADE:
+                state.setArmies(action.dest, state.getArmies(action.dest) * 3);
+                state.setOwner(action.dest, GameState::NEUTRAL);
+                break;
+            default:
+                break;
+        }
+    }
+
+    /**
+     * Takes a snapshot of the game for the search. Armies already committed to this turn's advances
+     * can't defend
+     */
+    GameState snapshot(Map *map, const vector<Player *> &activePlayers, Player *player) {
+        GameState state(*map, activePlayers, 0);
+        for (auto &territory : player->getOwnedTerritories()) {
+            state.setArmies(territory->getId(), territory->getAvailableArmies());
+        }
+        return state;
+    }
+}
+
+//=============================
+// MctsPlayerStrategy Implementation
+//=============================
+
+MctsPlayerStrategy::MctsPlayerStrategy(Player *player) : MctsPlayerStrategy(player, MctsConfig()) {}
+
+/**
+ * Creates the strategy with a given search budget. A budget without a limit on either playouts or time
+ * would never end, so the default number of playouts is used instead
+ *
+ * @param player
+ * @param config
+ */
+MctsPlayerStrategy::MctsPlayerStrategy(Player *player, MctsConfig config)
+        : PlayerStrategy(player),
+          config{config},
+          pool{nullptr},
+          rollouts{0},
+          searchSeconds{0} {
+    if (this->config.iterations <= 0 && this->config.timeLimitMs <= 0) {
+        this->config.iterations = MctsConfig().iterations;
+    }
+}
+
+// Worker threads can't be shared, so the copy creates its own pool when it needs one
+MctsPlayerStrategy::MctsPlayerStrategy(const MctsPlayerStrategy &other)
+        : PlayerStrategy(other),
+          config{other.config},
+          pool{nullptr},
+          rollouts{other.rollouts},
+          searchSeconds{other.searchSeconds} {}
+
+/**
+ * Swap method. Used for the copy-and-swap idiom
+ *
+ * @param a first element
+ * @param b second element
+ */
+void swap(MctsPlayerStrategy &a, MctsPlayerStrategy &b) {
+    using std::swap;
+
+    swap(a.player, b.player);
+    swap(a.config, b.config);
+    swap(a.pool, b.pool);
+    swap(a.rollouts, b.rollouts);
+    swap(a.searchSeconds, b.searchSeconds);
+}
+
+MctsPlayerStrategy &MctsPlayerStrategy::operator=(MctsPlayerStrategy other) {
+    swap(*this, other);
+    return *this;
+}
+
+/**
+ * Issue order using Monte Carlo Tree Search
+ *
+ * @param map
+ * @param deck
+ * @param activePlayers
+ * @return if the player is done issue orders
+ */
+bool MctsPlayerStrategy::issueOrder(Map *map, Deck *deck, vector<Player *> activePlayers) {
+    GameContext &context = player->getContext();
+    context.log() << "Employing [MctsPlayerStrategy] to issue orders" << endl;
+    if (player->getOwnedTerritories().empty()) {
+        context.pause();
+        return true;
+    }
+
+    vector<Action> actions = candidateActions(player, map);
+    if (actions.size() == 1 && actions[0].type == ActionType::STOP) {
+        context.pause();
+        return true;
+    }
+
+    Topology topology = buildTopology(map);
+    int me = std::find(activePlayers.begin(), activePlayers.end(), player) - activePlayers.begin();
+
+    // Make each action on the game, keep the resulting position and take the action back
+    MoveLog moveLog;
+    context.setMoveLog(&moveLog);
+    map->setMoveLog(&moveLog);
+    vector<GameState> children;
+    for (auto &action : actions) {
+        int checkpoint = moveLog.checkpoint();
+        makeAction(player, map, action);
+        children.push_back(snapshot(map, activePlayers, player));
+        applyToSnapshot(children.back(), action);
+        moveLog.undo(checkpoint);
+    }
+    map->setMoveLog(nullptr);
+    context.setMoveLog(nullptr);
+
+    // Tree-parallel search: every thread runs playouts on the same tree
+    Tree tree;
+    tree.nodes.reserve(actions.size() + 1 + max(config.iterations, 0));
+    tree.nodes.push_back({{ActionType::STOP, -1, -1, 0}, {}, 0, 0, 0});
+    for (int i = 0; i < actions.size(); ++i) {
+        tree.nodes.push_back({actions[i], {}, 0, 0, 0});
+        tree.nodes[0].children.push_back(i + 1);
+    }
+
+    auto start = Clock::now();
+    auto deadline = start + std::chrono::milliseconds(config.timeLimitMs);
+    bool timed = config.timeLimitMs > 0;
+    int threads = max(config.threads, 1);
+    int issued = countIssuedOrders(player);
+    vector<uint64_t> seeds(threads);
+    for (auto &seed : seeds) {
+        seed = context.getRng().next();
+    }
+    auto searchTree = [&, this](int thread) {
+        search(tree, children, actions, topology, me, issued, config, max(config.iterations, 0), timed, deadline,
+               seeds[thread]);
+    };
+    if (threads == 1) {
+        searchTree(0);
+    } else {
+        if (pool == nullptr) {
+            pool = new ThreadPool(threads);
+        }
+        for (int thread = 0; thread < threads; ++thread) {
+            pool->submit([&searchTree, thread] { searchTree(thread); });
+        }
+        pool->wait();
+    }
+
+    // Play the most visited action, the first one listed on ties
+    int best = 0;
+    for (int i = 1; i < actions.size(); ++i) {
+        if (tree.nodes[i + 1].visits > tree.nodes[best + 1].visits) {
+            best = i;
+        }
+    }
+    rollouts += tree.nodes[0].visits;
+    searchSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+
+    const Action &action = actions[best];
+    const vector<Territory *> &territories = map->getTerritories();
+    bool done = false;
+    switch (action.type) {
+        case ActionType::DEPLOY:
+            player->issueDeployOrder(territories[action.dest], action.armies);
+            break;
+        case ActionType::ATTACK:
+            player->issueAdvanceOrder(territories[action.origin], territories[action.dest], action.armies);
+            break;
+        case ActionType::BOMB: {
+            // Same as BombCard::play, without prompting for the target
+            BombCard *card = findCard<BombCard>(player->getHand());
+            deck->addCard(card);
+            player->getHand()->removeCard(card);
+            Order order = BombOrder{territories[action.dest]};
+            context.log() << player->getName() << " issued " << order << endl;
+            player->getOrders()->add(order);
+            break;
+        }
+        case ActionType::AIRLIFT: {
+            // Same as AirliftCard::play, without prompting for the territories and armies
+            AirliftCard *card = findCard<AirliftCard>(player->getHand());
+            deck->addCard(card);
+            player->getHand()->removeCard(card);
+            territories[action.origin]->reserveArmies(action.armies);
+            Order order = AirliftOrder{action.armies, territories[action.origin], territories[action.dest]};
+            context.log() << player->getName() << " issued " << order << endl;
+            player->getOrders()->add(order);
+            break;
+        }
+        case ActionType::BLOCKADE: {
+            // Same as BlockadeCard::play, without prompting for the territory
+            BlockadeCard *card = findCard<BlockadeCard>(player->getHand());
+            deck->addCard(card);
+            player->getHand()->removeCard(card);
+            Order order = BlockadeOrder{territories[action.dest]};
+            context.log() << player->getName() << " issued " << order << endl;
+            player->getOrders()->add(order);
+            break;
+        }
+        case ActionType::REINFORCE: {
+            // Same as ReinforcementCard::play, without prompting for the target
+            ReinforcementCard *card = findCard<ReinforcementCard>(player->getHand());
+            deck->addCard(card);
+            player->getHand()->removeCard(card);
+            territories[action.dest]->addArmies(action.armies);
+            Order order = DeployOrder{action.armies, territories[action.dest]};
+            context.log() << player->getName() << " issued " << order << endl;
+            player->getOrders()->add(order);
+            break;
+        }
+        case ActionType::STOP:
+            done = true;
+            break;
+    }
+
+    context.pause();
+    return done;
+}
+
+/**
+ * Return the territories to attack using the MCTS Strategy: every enemy neighbor, since the search
+ * decides which ones are worth it
+ *
+ * @param map
+ * @return territories to attack
+ */
+vector<Territory *> MctsPlayerStrategy::toAttack(Map *map) {
+    return player->getNeighboringTerritories(map);
+}
+
+/**
+ * Return the territories to defend using the MCTS Strategy: the territories bordering enemies
+ *
+ * @param map
+ * @return territories to defend
+ */
+vector<Territory *> MctsPlayerStrategy::toDefend(Map *map) {
+    vector<Territory *> frontier;
+    for (auto &territory : player->getOwnedTerritories()) {
+        if (territory->canAttack(map)) {
+            frontier.push_back(territory);
+        }
+    }
+    return frontier;
+}
+
+/**
+ * Helper function for polymorphic cloning
+ */
+PlayerStrategy *MctsPlayerStrategy::clone() {
+    return new MctsPlayerStrategy(*this);
+}
+
+/**
+ * Helper print function for polymorphic stream insertion
+ *
+ * @param out
+ */
+void MctsPlayerStrategy::print(ostream &out) const {
+    out << "MctsPlayerStrategy";
+}
+
+/**
+ * Returns the number of rollouts played over every decision so far
+ */
+long long MctsPlayerStrategy::getRollouts() const {
+    return rollouts;
+}
+
+/**
+ * Returns the time spent searching over every decision so far, in seconds
+ */
+double MctsPlayerStrategy::getSearchSeconds() const {
+    return searchSeconds;
+}
+
+MctsPlayerStrategy::~MctsPlayerStrategy() {
+    delete pool;
+}
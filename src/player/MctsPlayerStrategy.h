@@ -0,0 +1,71 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+
+#include "PlayerStrategies.h"
+#include "../utils/ThreadPool.h"
+
+using std::ostream;
+using std::vector;
+
+/**
+ * Search budget of the MCTS strategy, spent on every order it issues
+ */
+struct MctsConfig {
+    // Playouts per decision, over every thread. No limit when 0, in which case there must be a time
+    // limit. When neither is limited, the default number of playouts is used
+    int iterations = 400;
+    // Milliseconds per decision. No limit when 0
+    int timeLimitMs = 0;
+    // Threads running playouts on the same tree. Decisions are only reproducible from the game's seed
+    // with a single thread
+    int threads = 1;
+    // Rounds simulated by each playout before the position is scored
+    int rolloutRounds = 8;
+    // UCT exploration constant
+    double exploration = 0.7;
+};
+
+/**
+ * PlayerStrategy implementation which picks its orders with Monte Carlo Tree Search
+ *
+ * The root of the tree holds the candidate orders (deploying, advancing to attack, playing a bomb,
+ * reinforcement, airlift or blockade card, or ending the turn). The position after each candidate is
+ * found by making it on the game and undoing it with a MoveLog, and kept as a GameState snapshot. Below
+ * the root, the tree holds the player's next orders on this round and the following ones: deploying,
+ * attacking and ending their turn, while the other players play random turns. Each playout selects
+ * orders down the tree with UCT, adds a node, plays the rest of the game randomly and scores it.
+ *
+ * The search is tree-parallel: every thread runs playouts on the same tree, and nodes being played
+ * out by a thread carry a virtual loss so the other threads explore elsewhere. The most visited
+ * candidate is issued. Diplomacy cards are never played, since playouts don't model truces.
+ */
+class MctsPlayerStrategy : public PlayerStrategy {
+private:
+    MctsConfig config;
+    // Created on the first decision, when searching on more than one thread
+    cris_utils::ThreadPool *pool;
+    long long rollouts;
+    double searchSeconds;
+
+public:
+    MctsPlayerStrategy(Player *player);
+    MctsPlayerStrategy(Player *player, MctsConfig config);
+    MctsPlayerStrategy(const MctsPlayerStrategy &other);
+    friend void swap(MctsPlayerStrategy &a, MctsPlayerStrategy &b);
+    MctsPlayerStrategy &operator=(MctsPlayerStrategy other);
+
+    bool issueOrder(Map *map,
+                    Deck *deck,
+                    vector<Player *> activePlayers) override;
+    vector<Territory *> toAttack(Map *map) override;
+    vector<Territory *> toDefend(Map *map) override;
+    PlayerStrategy *clone() override;
+    void print(ostream &out) const override;
+
+    long long getRollouts() const;
+    double getSearchSeconds() const;
+
+    ~MctsPlayerStrategy() override;
+};
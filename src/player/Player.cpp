@@ -1,47 +1,63 @@
 #include "Player.h"
 
 #include "../cards/Cards.h"
+#include "../map/Map.h"
 #include "../orders/Orders.h"
 #include "../utils/Utils.h"
 #include "PlayerStrategies.h"
+#include "../GameContext.h"
+#include "../MoveLog.h"
 
 using std::endl;
-using std::cout;
 using std::to_string;
 
-using cris_utils::contains;
 using cris_utils::removeElement;
 using cris_utils::getIntInput;
 using cris_utils::getBoolInput;
 using cris_utils::setToVector;
 using cris_utils::pickFromList;
-
-// Neutral player. Available globally
-Player *neutralPlayer = new Player("Neutral Player");
+using cris_utils::Bitset;
 
 //=============================
 // Player Implementation
 //=============================
 
-Player::Player(string name)
+Player::Player(string name) : Player(name, &GameContext::standalone()) {}
+
+/**
+ * Creates a player taking part in the game described by the given context
+ *
+ * @param name
+ * @param context
+ */
+Player::Player(string name, GameContext *context)
         : name{name},
           armies{0},
           cardDue{false},
           ownedTerritories{set<Territory *>()},
+          ownedMask{},
+          continentCounts{},
           allies{set<Player *>()},
           hand{new Hand()},
           orders{new OrdersList()},
-          strategy{nullptr} {}
+          strategy{nullptr},
+          context{context} {}
 
 Player::Player(const Player &other)
         : name{other.name},
           armies{other.armies},
           cardDue{other.cardDue},
           ownedTerritories{set<Territory *>(other.ownedTerritories)},
+          ownedMask{other.ownedMask},
+          continentCounts{other.continentCounts},
           allies{set<Player *>(other.allies)},
           hand{new Hand(*other.hand)},
           orders{new OrdersList(*other.orders)},
-          strategy{other.strategy == nullptr ? nullptr : other.strategy->clone()} {
+          strategy{other.strategy == nullptr ? nullptr : other.strategy->clone()},
+          context{other.context} {
+    if (strategy != nullptr) {
+        strategy->setPlayer(this);
+    }
 }
 
 /**
@@ -57,10 +73,13 @@ void swap(Player &a, Player &b) {
     swap(a.armies, b.armies);
     swap(a.cardDue, b.cardDue);
     swap(a.ownedTerritories, b.ownedTerritories);
+    swap(a.ownedMask, b.ownedMask);
+    swap(a.continentCounts, b.continentCounts);
     swap(a.allies, b.allies);
     swap(a.hand, b.hand);
     swap(a.orders, b.orders);
     swap(a.strategy, b.strategy);
+    swap(a.context, b.context);
 }
 
 Player &Player::operator=(Player other) {
@@ -73,6 +92,7 @@ ostream &operator<<(ostream &out, const Player &obj) {
         << ", armies: " << obj.armies
         << ", cardDue: " << obj.cardDue
         << ", ownedTerritories[" << obj.ownedTerritories.size() << "]"
+        << ", continentCounts[" << obj.continentCounts.size() << "]"
         << ", allies[" << obj.allies.size() << "]"
         << ", hand[" << obj.hand->size() << "]"
         << ", orders[" << obj.orders->size() << "]"
@@ -86,7 +106,7 @@ ostream &operator<<(ostream &out, const Player &obj) {
  */
 vector<Territory *> Player::toDefend(Map *map) {
     if (strategy == nullptr) {
-        cout << name << " - toDefend: strategy not set!" << endl;
+        context->log() << name << " - toDefend: strategy not set!" << endl;
         return vector<Territory *>();
     }
     return strategy->toDefend(map);
@@ -97,7 +117,7 @@ vector<Territory *> Player::toDefend(Map *map) {
  */
 vector<Territory *> Player::toAttack(Map *map) {
     if (strategy == nullptr) {
-        cout << name << " - toAttack: strategy not set!" << endl;
+        context->log() << name << " - toAttack: strategy not set!" << endl;
         return vector<Territory *>();
     }
     return strategy->toAttack(map);
@@ -113,7 +133,7 @@ vector<Territory *> Player::toAttack(Map *map) {
  */
 bool Player::issueOrder(Map *map, Deck *deck, vector<Player *> activePlayers) {
     if (strategy == nullptr) {
-        cout << name << " - issueOrder: strategy not set!" << endl;
+        context->log() << name << " - issueOrder: strategy not set!" << endl;
         return true;
     }
     return strategy->issueOrder(map, deck, activePlayers);
@@ -126,13 +146,12 @@ bool Player::issueOrder(Map *map, Deck *deck, vector<Player *> activePlayers) {
  * @param territory
  */
 void Player::issueDeployOrder(Territory *territory, int armies) {
-    DeployOrder *order = new DeployOrder(armies, territory);
+    Order order = DeployOrder{armies, territory};
     if (this->armies < armies) {
-        cout << "Invalid" << *order << ": Player doesn't have enough armies: " << this->armies;
-        delete order;
+        context->log() << "Invalid" << order << ": Player doesn't have enough armies: " << this->armies;
         return;
     }
-    cout << name << " issued " << *order << endl;
+    context->log() << name << " issued " << order << endl;
     removeArmies(armies);
     territory->addArmies(armies);
     orders->add(order);
@@ -146,16 +165,16 @@ void Player::issueDeployOrder(Territory *territory, int armies) {
  */
 void Player::issueAdvanceOrder(Territory *origin, Territory *dest, int armies) {
     if (origin->getAvailableArmies() < armies) {
-        cout << "Invalid advance order. "
+        context->log() << "Invalid advance order. "
              << origin->getName() << ": " << origin->getAvailableArmies()
              << ", needed: " << armies;
         return;
     }
 
-    AdvanceOrder *order = new AdvanceOrder(armies, origin, dest);
+    Order order = AdvanceOrder{armies, origin, dest};
     origin->reserveArmies(armies);
 
-    cout << name << " issued " << *order << endl;
+    context->log() << name << " issued " << order << endl;
     orders->add(order);
 }
 
@@ -170,14 +189,14 @@ void Player::issueAdvanceOrder(Territory *origin, Territory *dest, int armies) {
 void Player::captureTerritory(Territory *territory) {
     // If territory belonged to a player, remove from their ownedTerritories
     if (territory->getPlayer() != nullptr) {
-        removeElement(territory->getPlayer()->ownedTerritories, territory);
+        territory->getPlayer()->removeOwned(territory);
     }
 
     territory->setPlayer(this);
 
-    ownedTerritories.insert(territory);
+    addOwned(territory);
     // If the player captures a territory, they are due a card at the end of the round
-    cardDue = true;
+    setCardDue(true);
 }
 
 /**
@@ -187,11 +206,12 @@ void Player::captureTerritory(Territory *territory) {
  * @param territory
  */
 void Player::loseTerritory(Territory *territory) {
-    removeElement(ownedTerritories, territory);
+    removeOwned(territory);
 
+    Player *neutralPlayer = context->getNeutralPlayer();
     territory->setPlayer(neutralPlayer);
 
-    neutralPlayer->ownedTerritories.insert(territory);
+    neutralPlayer->addOwned(territory);
 }
 
 /**
@@ -201,7 +221,8 @@ void Player::loseTerritory(Territory *territory) {
  * @return
  */
 bool Player::owns(Territory *territory) {
-    return contains(ownedTerritories, territory);
+    // Looked up in place: contains would copy the set, and orders check ownership on every validation
+    return ownedTerritories.count(territory) > 0;
 }
 
 /**
@@ -211,7 +232,23 @@ bool Player::owns(Territory *territory) {
  * @see NegotiateOrder
  */
 void Player::addAlly(Player *otherPlayer) {
-    allies.insert(otherPlayer);
+    if (allies.insert(otherPlayer).second && context->getMoveLog() != nullptr) {
+        context->getMoveLog()->recordAllyAdded(this, otherPlayer);
+    }
+}
+
+/**
+ * Replaces every ally by its copy. Used when a whole game is copied
+ *
+ * @param copies copy of each player of the original game
+ */
+void Player::remapAllies(const map<Player *, Player *> &copies) {
+    set<Player *> copiedAllies{};
+    for (auto &ally : allies) {
+        auto copy = copies.find(ally);
+        copiedAllies.insert(copy == copies.end() ? ally : copy->second);
+    }
+    allies = copiedAllies;
 }
 
 /**
@@ -228,16 +265,12 @@ void Player::resetAllies() {
  * @return a list of neighboring enemy territories
  */
 const vector<Territory *> Player::getNeighboringTerritories(Map *map) const {
+    Bitset frontier = map->getFrontier(ownedMask);
+
+    // Ids follow map order, so the list is presented the same way regardless of ownership
     vector<Territory *> neighbors{};
-    for (auto &territory : map->getTerritories()) {
-        if (territory->getPlayer() != this) {
-            for (auto &ownedTerritory : ownedTerritories) {
-                if (map->areAdjacent(territory, ownedTerritory)) {
-                    neighbors.push_back(territory);
-                    break;
-                }
-            }
-        }
+    for (int id = frontier.next(0); id != -1; id = frontier.next(id + 1)) {
+        neighbors.push_back(map->getTerritories()[id]);
     }
     return neighbors;
 }
@@ -258,6 +291,24 @@ const set<Territory *> &Player::getOwnedTerritories() const {
     return ownedTerritories;
 }
 
+const Bitset &Player::getOwnedMask() const {
+    return ownedMask;
+}
+
+/**
+ * Returns the number of territories the player owns in a given continent
+ *
+ * @param continent
+ * @return number of owned territories in the continent
+ */
+int Player::getTerritoryCount(Continent *continent) const {
+    int id = continent->getId();
+    if (id < 0 || id >= continentCounts.size()) {
+        return 0;
+    }
+    return continentCounts[id];
+}
+
 Hand *Player::getHand() {
     return hand;
 }
@@ -274,18 +325,29 @@ PlayerStrategy *Player::getStrategy() const {
     return strategy;
 }
 
+GameContext &Player::getContext() const {
+    return *context;
+}
+
 void Player::addArmies(int armies) {
+    if (context->getMoveLog() != nullptr) {
+        context->getMoveLog()->recordPlayerArmies(this, this->armies, this->armies + armies);
+    }
     this->armies += armies;
 }
 
 void Player::removeArmies(int armies) {
-    this->armies -= armies;
-    if (this->armies < 0) {
-        this->armies = 0;
+    int remaining = this->armies - armies < 0 ? 0 : this->armies - armies;
+    if (context->getMoveLog() != nullptr) {
+        context->getMoveLog()->recordPlayerArmies(this, this->armies, remaining);
     }
+    this->armies = remaining;
 }
 
 void Player::setCardDue(bool cardDue) {
+    if (context->getMoveLog() != nullptr) {
+        context->getMoveLog()->recordCardDue(this, Player::cardDue, cardDue);
+    }
     Player::cardDue = cardDue;
 }
 
@@ -297,6 +359,71 @@ void Player::setStrategy(PlayerStrategy *strategy) {
     this->strategy = strategy;
 }
 
+/**
+ * Points a copy of a player at a copy of its game. Owned territories are looked up by id in the
+ * copied map and take the player as their owner, and the copied game's context is used from now on.
+ *
+ * Orders and allies aren't remapped.
+ *
+ * @param map copy of the map the player was playing on
+ * @param context context of the copied game
+ */
+void Player::rebind(Map *map, GameContext *context) {
+    this->context = context;
+    ownedTerritories.clear();
+    for (int id = ownedMask.next(0); id != -1; id = ownedMask.next(id + 1)) {
+        Territory *territory = map->getTerritories()[id];
+        ownedTerritories.insert(territory);
+        territory->setPlayer(this);
+    }
+}
+
+/**
+ * Adds a territory to the owned territories, keeping the owned mask and continent counts in sync
+ *
+ * @param territory
+ */
+void Player::addOwned(Territory *territory) {
+    if (!ownedTerritories.insert(territory).second) {
+        return;
+    }
+    int continentId = territory->getContinent()->getId();
+    if (context->getMoveLog() != nullptr) {
+        if (continentId >= static_cast<int>(continentCounts.size())) {
+            context->getMoveLog()->recordContinentCountsGrown(this, continentCounts.size(), continentId + 1);
+        }
+        context->getMoveLog()->recordOwnedAdded(this, territory);
+    }
+    ownedMask.set(territory->getId());
+
+    if (continentId >= 0) {
+        if (continentId >= continentCounts.size()) {
+            continentCounts.resize(continentId + 1, 0);
+        }
+        continentCounts[continentId]++;
+    }
+}
+
+/**
+ * Removes a territory from the owned territories, keeping the owned mask and continent counts in sync
+ *
+ * @param territory
+ */
+void Player::removeOwned(Territory *territory) {
+    if (ownedTerritories.erase(territory) == 0) {
+        return;
+    }
+    if (context->getMoveLog() != nullptr) {
+        context->getMoveLog()->recordOwnedRemoved(this, territory);
+    }
+    ownedMask.reset(territory->getId());
+
+    int continentId = territory->getContinent()->getId();
+    if (continentId >= 0 && continentId < continentCounts.size()) {
+        continentCounts[continentId]--;
+    }
+}
+
 Player::~Player() {
     // Player doesn't manage the memory for the territories or other players
     delete hand;
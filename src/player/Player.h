@@ -4,13 +4,18 @@
 #include <string>
 #include <iostream>
 #include <set>
+#include <map>
 
+#include "../utils/Bitset.h"
+
+using std::map;
 using std::ostream;
 using std::string;
 using std::vector;
 using std::set;
 
 class Territory;
+class Continent;
 class Hand;
 class Order;
 class OrdersList;
@@ -18,6 +23,8 @@ class Card;
 class Deck;
 class Map;
 class PlayerStrategy;
+class GameContext;
+class MoveLog;
 enum class OrderType;
 
 /**
@@ -29,12 +36,18 @@ private:
     int armies;
     bool cardDue;
     set<Territory *> ownedTerritories;
+    // Ids of the owned territories, kept in sync with ownedTerritories
+    cris_utils::Bitset ownedMask;
+    // Number of owned territories in each continent, indexed by continent id
+    vector<int> continentCounts;
     set<Player *> allies;
     Hand *hand;
     OrdersList *orders;
     PlayerStrategy *strategy;
+    GameContext *context;
 public:
     Player(string name);
+    Player(string name, GameContext *context);
     Player(const Player &other);
     friend void swap(Player &a, Player &b);
     Player &operator=(Player other);
@@ -51,17 +64,22 @@ public:
     void loseTerritory(Territory *territory);
     bool owns(Territory *territory);
     void addAlly(Player *otherPlayer);
+    void remapAllies(const map<Player *, Player *> &copies);
     void resetAllies();
+    void rebind(Map *map, GameContext *context);
     const vector<Territory *> getNeighboringTerritories(Map *map) const;
 
     const string &getName() const;
     const int &getArmies() const;
     bool isCardDue() const;
     const set<Territory *> &getOwnedTerritories() const;
+    const cris_utils::Bitset &getOwnedMask() const;
+    int getTerritoryCount(Continent *continent) const;
     Hand *getHand();
     OrdersList *getOrders() const;
     const set<Player *> &getAllies() const;
     PlayerStrategy *getStrategy() const;
+    GameContext &getContext() const;
 
     void addArmies(int armies);
     void removeArmies(int armies);
@@ -70,6 +88,12 @@ public:
 
     ~Player();
 
+private:
+    // Reverts and replays changes directly, without recording them again
+    friend class MoveLog;
+
+    void addOwned(Territory *territory);
+    void removeOwned(Territory *territory);
+
 };
 
-extern Player *neutralPlayer;
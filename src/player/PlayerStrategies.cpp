@@ -7,17 +7,21 @@
 #include "../player/Player.h"
 #include "../cards/Cards.h"
 #include "../orders/Orders.h"
+#include "../GameContext.h"
 
 using std::set;
 using std::vector;
 using std::sort;
+using std::pair;
+
+using cris_utils::Span;
+using cris_utils::Bitset;
 
 using cris_utils::setToVector;
 using cris_utils::pickFromList;
 using cris_utils::removeElement;
 using cris_utils::getBoolInput;
 using cris_utils::getIntInput;
-using cris_utils::getContinueInput;
 using cris_utils::printList;
 
 namespace {
@@ -49,44 +53,72 @@ namespace {
     }
 
     /**
-     * Comparator function to sort territories from low to high armies
+     * Sorts territory ids by army value, read straight from the map's territory store. Ties are broken
+     * by id, so the order doesn't depend on where territories are allocated
+     *
+     * The sorting defaults from low to high, but can be reversed.
      *
-     * @param t0
-     * @param t1
-     * @return if t0 comes before t1
+     * @param map
+     * @param ids ids of the territories to sort
+     * @param reverse
+     * @return Sorted vector of Territories
      */
-    bool lowToHigh(Territory *t0, Territory *t1) {
-        return t0->getArmies() < t1->getArmies();
+    vector<Territory *> sortIdsByArmies(Map *map, const vector<int> &ids, bool reverse) {
+        Span<int32_t> armies = map->getTerritoryStore().getAllArmies();
+        vector<pair<int64_t, int>> keys;
+        keys.reserve(ids.size());
+        for (int id : ids) {
+            keys.emplace_back(reverse ? -static_cast<int64_t>(armies[id]) : armies[id], id);
+        }
+        sort(keys.begin(), keys.end());
+
+        const vector<Territory *> &territories = map->getTerritories();
+        vector<Territory *> sorted;
+        sorted.reserve(keys.size());
+        for (auto &key : keys) {
+            sorted.push_back(territories[key.second]);
+        }
+        return sorted;
     }
 
     /**
-     * Comparator function to sort territories from high to low armies
+     * Sort territories by army value.
      *
-     * @param t0
-     * @param t1
-     * @return if t0 comes after t1
+     * The sorting defaults from low to high, but can be reversed.
+     *
+     * @param map map the territories are part of
+     * @param territories
+     * @param reverse
+     * @return Sorted vector of Territories
      */
-    bool highToLow(Territory *t0, Territory *t1) {
-        return t0->getArmies() > t1->getArmies();
+    vector<Territory *> sortTerritoriesByArmies(Map *map, const vector<Territory *> &territories,
+                                                bool reverse = false) {
+        vector<int> ids;
+        ids.reserve(territories.size());
+        for (auto &territory : territories) {
+            ids.push_back(territory->getId());
+        }
+        return sortIdsByArmies(map, ids, reverse);
     }
 
     /**
-     * Sort territories by army value.
+     * Sort the territories owned by a player by army value.
      *
      * The sorting defaults from low to high, but can be reversed.
      *
-     * @param territories
+     * @param map
+     * @param player
      * @param reverse
      * @return Sorted vector of Territories
      */
-    vector<Territory *> sortTerritoriesByArmies(vector<Territory *> territories, bool reverse = false) {
-        if (reverse) {
-            sort(territories.begin(), territories.end(), highToLow);
-        } else {
-            sort(territories.begin(), territories.end(), lowToHigh);
+    vector<Territory *> sortOwnedTerritoriesByArmies(Map *map, Player *player, bool reverse = false) {
+        const Bitset &owned = player->getOwnedMask();
+        vector<int> ids;
+        ids.reserve(owned.count());
+        for (int id = owned.next(0); id != -1; id = owned.next(id + 1)) {
+            ids.push_back(id);
         }
-
-        return territories;
+        return sortIdsByArmies(map, ids, reverse);
     }
 }
 
@@ -102,6 +134,15 @@ ostream &operator<<(ostream &out, const PlayerStrategy &obj) {
     return out;
 }
 
+/**
+ * Sets the player using the strategy. Used when a strategy is cloned for a copy of its player
+ *
+ * @param player
+ */
+void PlayerStrategy::setPlayer(Player *player) {
+    this->player = player;
+}
+
 // PlayerStrategy isn't responsible for managing Player memory
 PlayerStrategy::~PlayerStrategy() {}
 
@@ -152,7 +193,7 @@ HumanPlayerStrategy::HumanPlayerStrategy(Player *player) : PlayerStrategy(player
  * @return if the player is done issue orders
  */
 bool HumanPlayerStrategy::issueOrder(Map *map, Deck *deck, vector<Player *> activePlayers) {
-    cout << "Employing [HumanPlayerStrategy] to issue orders" << endl;
+    player->getContext().log() << "Employing [HumanPlayerStrategy] to issue orders" << endl;
     // Deploy orders
     if (player->getArmies() > 0) {
         Territory *territory = pickFromList(
@@ -209,8 +250,8 @@ bool HumanPlayerStrategy::issueOrder(Map *map, Deck *deck, vector<Player *> acti
                                         "Pick a card to play",
                                         player->getHand()->getCards());
         cout << "Playing " << *cardToPlay << endl;
-        Order *cardOrder = cardToPlay->play(player, deck, map, activePlayers);
-        cout << player->getName() << " issued " << *cardOrder << endl;
+        Order cardOrder = cardToPlay->play(player, deck, map, activePlayers);
+        player->getContext().log() << player->getName() << " issued " << cardOrder << endl;
         player->getOrders()->add(cardOrder);
     }
     return getBoolInput("Are you done issuing orders?");
@@ -301,7 +342,7 @@ AggressivePlayerStrategy::AggressivePlayerStrategy(Player *player) : PlayerStrat
  * @return if the player is done issue orders
  */
 bool AggressivePlayerStrategy::issueOrder(Map *map, Deck *deck, vector<Player *> activePlayers) {
-    cout << "Employing [AggressivePlayerStrategy] to issue orders" << endl;
+    player->getContext().log() << "Employing [AggressivePlayerStrategy] to issue orders" << endl;
     vector<Territory *> targets = toAttack(map);
     vector<Territory *> attackers = toDefend(map);
     Territory *attacker = attackers[0];
@@ -309,7 +350,7 @@ bool AggressivePlayerStrategy::issueOrder(Map *map, Deck *deck, vector<Player *>
     if (player->getArmies() > 0) {
         // If player has armies, deploy them all to strongest territory that can attack
         player->issueDeployOrder(attacker, player->getArmies());
-        getContinueInput();
+        player->getContext().pause();
         return false;
     }
 
@@ -321,11 +362,11 @@ bool AggressivePlayerStrategy::issueOrder(Map *map, Deck *deck, vector<Player *>
             armies = availableArmies;
         }
         player->issueAdvanceOrder(attacker, target, armies);
-        getContinueInput();
+        player->getContext().pause();
         return false;
     }
 
-    getContinueInput();
+    player->getContext().pause();
     return true;
 
 }
@@ -345,10 +386,10 @@ vector<Territory *> AggressivePlayerStrategy::toAttack(Map *map) {
             // Check if neighbor has already been targeted
             bool alreadyTargeted = false;
             for (int i = 0; i < player->getOrders()->size(); ++i) {
-                Order *order = (*player->getOrders())[i];
-                if (order->getType() == OrderType::ADVANCE) {
-                    AdvanceOrder *advanceOrder = dynamic_cast<AdvanceOrder *>(order);
-                    if (advanceOrder->getDest() == neighbor) {
+                const Order &order = (*player->getOrders())[i];
+                if (order.getType() == OrderType::ADVANCE) {
+                    const AdvanceOrder *advanceOrder = order.as<AdvanceOrder>();
+                    if (advanceOrder->dest == neighbor) {
                         alreadyTargeted = true;
                     }
                 }
@@ -360,7 +401,7 @@ vector<Territory *> AggressivePlayerStrategy::toAttack(Map *map) {
         }
     }
 
-    return sortTerritoriesByArmies(targets);
+    return sortTerritoriesByArmies(map, targets);
 }
 
 /**
@@ -370,8 +411,7 @@ vector<Territory *> AggressivePlayerStrategy::toAttack(Map *map) {
  * @return territories to defend
  */
 vector<Territory *> AggressivePlayerStrategy::toDefend(Map *map) {
-    vector<Territory *> sortedTerritories = sortTerritoriesByArmies(
-            setToVector(player->getOwnedTerritories()), true);
+    vector<Territory *> sortedTerritories = sortOwnedTerritoriesByArmies(map, player, true);
 
     // Loop through territories from the strongest to weakest
     for (auto &territory : sortedTerritories) {
@@ -414,7 +454,7 @@ BenevolentPlayerStrategy::BenevolentPlayerStrategy(Player *player) : PlayerStrat
  * @return if the player is done issue orders
  */
 bool BenevolentPlayerStrategy::issueOrder(Map *map, Deck *deck, vector<Player *> activePlayers) {
-    cout << "Employing [BenevolentPlayerStrategy] to issue orders" << endl;
+    player->getContext().log() << "Employing [BenevolentPlayerStrategy] to issue orders" << endl;
     vector<Territory *> defend = toDefend(map);
 
     if (player->getArmies() > 0) {
@@ -424,13 +464,12 @@ bool BenevolentPlayerStrategy::issueOrder(Map *map, Deck *deck, vector<Player *>
             armies = player->getArmies();
         }
         player->issueDeployOrder(defend[0], armies);
-        getContinueInput();
+        player->getContext().pause();
         return false;
     }
 
     for (auto &dest : defend) {
-        vector<Territory *> sortedByStrongest = sortTerritoriesByArmies(
-                setToVector(player->getOwnedTerritories()), true);
+        vector<Territory *> sortedByStrongest = sortOwnedTerritoriesByArmies(map, player, true);
         for (auto &origin : sortedByStrongest) {
             if (origin != dest && map->areAdjacent(origin, dest)
                 && origin->getArmies() > dest->getArmies()
@@ -438,12 +477,12 @@ bool BenevolentPlayerStrategy::issueOrder(Map *map, Deck *deck, vector<Player *>
                 // Send over most available armies to protect
                 int armies = dest->getAvailableArmies() / 2 + 1;
                 player->issueAdvanceOrder(origin, dest, armies);
-                getContinueInput();
+                player->getContext().pause();
                 return true;
             }
         }
     }
-    getContinueInput();
+    player->getContext().pause();
     return true;
 }
 
@@ -465,7 +504,7 @@ vector<Territory *> BenevolentPlayerStrategy::toAttack(Map *map) {
  * @return territories to defend
  */
 vector<Territory *> BenevolentPlayerStrategy::toDefend(Map *map) {
-    return sortTerritoriesByArmies(setToVector(player->getOwnedTerritories()));
+    return sortOwnedTerritoriesByArmies(map, player);
 }
 
 /**
@@ -500,8 +539,8 @@ NeutralPlayerStrategy::NeutralPlayerStrategy(Player *player) : PlayerStrategy(pl
  */
 bool NeutralPlayerStrategy::issueOrder(Map *map, Deck *deck, vector<Player *> activePlayers) {
     // Never issues orders
-    cout << "Employing [NeutralPlayerStrategy] to issue orders" << endl;
-    getContinueInput();
+    player->getContext().log() << "Employing [NeutralPlayerStrategy] to issue orders" << endl;
+    player->getContext().pause();
     return true;
 }
 
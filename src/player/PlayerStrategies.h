@@ -31,6 +31,8 @@ public:
     virtual PlayerStrategy *clone() = 0;
     virtual void print(ostream &out) const = 0;
 
+    void setPlayer(Player *player);
+
     virtual ~PlayerStrategy();
 };
 
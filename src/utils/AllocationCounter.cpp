@@ -0,0 +1,33 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    // Heap allocations made since the program started, counted by the replaced operator new below
+    std::atomic<long> allocations{0};
+}
+
+/**
+ * Returns the number of heap allocations made through new since the program started
+ */
+long cris_utils::allocationCount() {
+    return allocations.load();
+}
+
+void *operator new(std::size_t size) {
+    allocations++;
+    if (void *memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+namespace cris_utils {
+    /**
+     * Counts the heap allocations of a program, for benchmarks measuring what allocates.
+     *
+     * Programs linking AllocationCounter.cpp get a replaced global operator new which counts every
+     * allocation made through new, and the matching operator delete. Only benchmark targets should
+     * link it.
+     */
+    long allocationCount();
+}
@@ -0,0 +1,180 @@
+#include "Bitset.h"
+
+#include <algorithm>
+
+using std::min;
+
+using cris_utils::Bitset;
+
+namespace {
+    const int WORD_BITS = 64;
+
+    int wordsFor(int bits) {
+        return (bits + WORD_BITS - 1) / WORD_BITS;
+    }
+}
+
+Bitset::Bitset() : words{} {}
+
+Bitset::Bitset(int size) : words(wordsFor(size), 0) {}
+
+ostream &cris_utils::operator<<(ostream &out, const Bitset &obj) {
+    out << "Bitset{ count: " << obj.count() << " }";
+    return out;
+}
+
+/**
+ * Compares two bitsets. Bits past the end of the shorter bitset are considered unset.
+ */
+bool cris_utils::operator==(const Bitset &a, const Bitset &b) {
+    const vector<uint64_t> &shorter = a.words.size() < b.words.size() ? a.words : b.words;
+    const vector<uint64_t> &longer = a.words.size() < b.words.size() ? b.words : a.words;
+    for (int i = 0; i < shorter.size(); ++i) {
+        if (shorter[i] != longer[i]) {
+            return false;
+        }
+    }
+    for (int i = shorter.size(); i < longer.size(); ++i) {
+        if (longer[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Makes room for at least the given number of bits. Never shrinks.
+ *
+ * @param size number of bits
+ */
+void Bitset::resize(int size) {
+    if (wordsFor(size) > words.size()) {
+        words.resize(wordsFor(size), 0);
+    }
+}
+
+void Bitset::set(int i) {
+    resize(i + 1);
+    words[i / WORD_BITS] |= uint64_t{1} << (i % WORD_BITS);
+}
+
+void Bitset::reset(int i) {
+    if (i / WORD_BITS < words.size()) {
+        words[i / WORD_BITS] &= ~(uint64_t{1} << (i % WORD_BITS));
+    }
+}
+
+void Bitset::clear() {
+    std::fill(words.begin(), words.end(), 0);
+}
+
+bool Bitset::test(int i) const {
+    return i / WORD_BITS < words.size() && (words[i / WORD_BITS] >> (i % WORD_BITS)) & 1;
+}
+
+/**
+ * Returns the index of the first set bit at or after a given index, or -1 if there is none.
+ *
+ * Used to iterate over set bits: for (int i = bits.next(0); i != -1; i = bits.next(i + 1))
+ *
+ * @param from
+ * @return index of the next set bit
+ */
+int Bitset::next(int from) const {
+    int w = from / WORD_BITS;
+    if (w >= words.size()) {
+        return -1;
+    }
+    uint64_t word = words[w] & (~uint64_t{0} << (from % WORD_BITS));
+    while (word == 0) {
+        if (++w >= words.size()) {
+            return -1;
+        }
+        word = words[w];
+    }
+    return w * WORD_BITS + __builtin_ctzll(word);
+}
+
+/**
+ * Returns the number of set bits
+ */
+int Bitset::count() const {
+    int total = 0;
+    for (uint64_t word : words) {
+        total += __builtin_popcountll(word);
+    }
+    return total;
+}
+
+/**
+ * Returns the number of bits currently stored. Always a multiple of 64.
+ */
+int Bitset::size() const {
+    return words.size() * WORD_BITS;
+}
+
+bool Bitset::none() const {
+    for (uint64_t word : words) {
+        if (word != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns whether every bit set in this bitset is also set in the other one
+ */
+bool Bitset::isSubsetOf(const Bitset &other) const {
+    int common = min(words.size(), other.words.size());
+    uint64_t missing = 0;
+    for (int i = 0; i < common; ++i) {
+        missing |= words[i] & ~other.words[i];
+    }
+    for (int i = common; i < words.size(); ++i) {
+        missing |= words[i];
+    }
+    return missing == 0;
+}
+
+/**
+ * Returns whether the two bitsets have at least one set bit in common
+ */
+bool Bitset::intersects(const Bitset &other) const {
+    int common = min(words.size(), other.words.size());
+    uint64_t shared = 0;
+    for (int i = 0; i < common; ++i) {
+        shared |= words[i] & other.words[i];
+    }
+    return shared != 0;
+}
+
+Bitset &Bitset::operator|=(const Bitset &other) {
+    resize(other.size());
+    for (int i = 0; i < other.words.size(); ++i) {
+        words[i] |= other.words[i];
+    }
+    return *this;
+}
+
+Bitset &Bitset::operator&=(const Bitset &other) {
+    int common = min(words.size(), other.words.size());
+    for (int i = 0; i < common; ++i) {
+        words[i] &= other.words[i];
+    }
+    for (int i = common; i < words.size(); ++i) {
+        words[i] = 0;
+    }
+    return *this;
+}
+
+/**
+ * Clears every bit which is set in the other bitset
+ */
+Bitset &Bitset::andNot(const Bitset &other) {
+    int common = min(words.size(), other.words.size());
+    for (int i = 0; i < common; ++i) {
+        words[i] &= ~other.words[i];
+    }
+    return *this;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+using std::ostream;
+using std::vector;
+
+namespace cris_utils {
+    /**
+     * Dynamically sized set of territory ids, stored as a packed array of 64-bit words.
+     *
+     * Set operations work word by word over contiguous storage, so the compiler can vectorize them.
+     * Bits past the end of a bitset are treated as unset, so bitsets of different sizes can be
+     * combined. Setting a bit past the end grows the bitset.
+     *
+     * Note that since this class doesn't have pointer attributes, the default
+     * copy constructor, assignment operator and destructor are used
+     */
+    class Bitset {
+    private:
+        vector<uint64_t> words;
+
+    public:
+        Bitset();
+        explicit Bitset(int size);
+        friend ostream &operator<<(ostream &out, const Bitset &obj);
+        friend bool operator==(const Bitset &a, const Bitset &b);
+
+        void resize(int size);
+        void set(int i);
+        void reset(int i);
+        void clear();
+        bool test(int i) const;
+        int next(int from) const;
+        int count() const;
+        int size() const;
+        bool none() const;
+        bool isSubsetOf(const Bitset &other) const;
+        bool intersects(const Bitset &other) const;
+
+        Bitset &operator|=(const Bitset &other);
+        Bitset &operator&=(const Bitset &other);
+        Bitset &andNot(const Bitset &other);
+    };
+
+    ostream &operator<<(ostream &out, const Bitset &obj);
+    bool operator==(const Bitset &a, const Bitset &b);
+}
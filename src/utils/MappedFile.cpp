@@ -0,0 +1,81 @@
+#include "MappedFile.h"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using cris_utils::MappedFile;
+
+MappedFile::MappedFile(const string &path) : data{nullptr}, size{0} {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        void *mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            // The file is read front to back
+            madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+            data = static_cast<const char *>(mapped);
+            size = info.st_size;
+        }
+    }
+    close(fd);
+}
+
+ostream &cris_utils::operator<<(ostream &out, const MappedFile &obj) {
+    out << "MappedFile{ size: " << obj.size << " }";
+    return out;
+}
+
+bool MappedFile::isOpen() const {
+    return data != nullptr;
+}
+
+const char *MappedFile::getData() const {
+    return data;
+}
+
+size_t MappedFile::getSize() const {
+    return size;
+}
+
+/**
+ * Returns the whole file as text
+ */
+string_view MappedFile::getText() const {
+    return string_view(data, size);
+}
+
+MappedFile::~MappedFile() {
+    if (data != nullptr) {
+        munmap(const_cast<char *>(data), size);
+    }
+}
+
+/**
+ * Takes the next line off the front of a text, the way getline would: the line doesn't include its
+ * newline, and the text's last line doesn't need one.
+ *
+ * @param text remaining text, advanced past the line
+ * @param line receives the line
+ * @return whether there was a line left
+ */
+bool cris_utils::nextLine(string_view &text, string_view &line) {
+    if (text.empty()) {
+        return false;
+    }
+    auto newline = static_cast<const char *>(memchr(text.data(), '\n', text.size()));
+    if (newline == nullptr) {
+        line = text;
+        text = string_view();
+    } else {
+        line = string_view(text.data(), newline - text.data());
+        text.remove_prefix(newline - text.data() + 1);
+    }
+    return true;
+}
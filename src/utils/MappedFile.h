@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+using std::ostream;
+using std::string;
+using std::string_view;
+
+namespace cris_utils {
+    /**
+     * Read-only view of a whole file, mapped in memory.
+     *
+     * Lets loaders scan a file as a single buffer instead of reading it through a stream. A file
+     * which can't be opened, or is empty, gives an empty view. The file is unmapped when the object is
+     * destroyed, so views into it must not outlive it; for that reason it can't be copied.
+     */
+    class MappedFile {
+    private:
+        const char *data;
+        size_t size;
+
+    public:
+        explicit MappedFile(const string &path);
+        MappedFile(const MappedFile &other) = delete;
+        MappedFile &operator=(const MappedFile &other) = delete;
+        friend ostream &operator<<(ostream &out, const MappedFile &obj);
+
+        bool isOpen() const;
+        const char *getData() const;
+        size_t getSize() const;
+        string_view getText() const;
+
+        ~MappedFile();
+    };
+
+    ostream &operator<<(ostream &out, const MappedFile &obj);
+
+    bool nextLine(string_view &text, string_view &line);
+}
@@ -0,0 +1,76 @@
+#include "NameTable.h"
+
+#include <functional>
+
+namespace cris_utils {
+    NameTable::NameTable() : names{}, hashes{}, slots(64, 0) {}
+
+    ostream &operator<<(ostream &out, const NameTable &obj) {
+        out << "NameTable{ "
+            << "names: " << obj.names.size()
+            << ", slots: " << obj.slots.size()
+            << " }";
+        return out;
+    }
+
+    /**
+     * Doubles the number of slots and places every name again
+     */
+    void NameTable::grow() {
+        slots.assign(slots.size() * 2, 0);
+        size_t mask = slots.size() - 1;
+        for (int id = 0; id < names.size(); ++id) {
+            size_t slot = hashes[id] & mask;
+            while (slots[slot] != 0) {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = id + 1;
+        }
+    }
+
+    /**
+     * Returns the id of a name, or -1 if it wasn't seen
+     */
+    int NameTable::find(string_view name) const {
+        size_t hash = std::hash<string_view>()(name);
+        size_t mask = slots.size() - 1;
+        for (size_t slot = hash & mask; slots[slot] != 0; slot = (slot + 1) & mask) {
+            int id = slots[slot] - 1;
+            if (hashes[id] == hash && names[id] == name) {
+                return id;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * Returns the id of a name, giving it the next id if it wasn't seen
+     */
+    int NameTable::intern(string_view name) {
+        size_t hash = std::hash<string_view>()(name);
+        size_t mask = slots.size() - 1;
+        size_t slot = hash & mask;
+        for (; slots[slot] != 0; slot = (slot + 1) & mask) {
+            int id = slots[slot] - 1;
+            if (hashes[id] == hash && names[id] == name) {
+                return id;
+            }
+        }
+        int id = names.size();
+        names.push_back(name);
+        hashes.push_back(hash);
+        slots[slot] = id + 1;
+        if (names.size() * 2 > slots.size()) {
+            grow();
+        }
+        return id;
+    }
+
+    string_view NameTable::getName(int id) const {
+        return names[id];
+    }
+
+    int NameTable::size() const {
+        return names.size();
+    }
+}
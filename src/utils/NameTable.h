@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+using std::ostream;
+using std::string_view;
+using std::vector;
+
+namespace cris_utils {
+    /**
+     * Hash table giving a dense id to each distinct name, in the order the names are first seen.
+     *
+     * Uses open addressing with linear probing over a power of two number of slots, kept at most half
+     * full. Names are stored as views, so the text they come from must outlive the table.
+     *
+     * Note that since this class doesn't have pointer attributes, the default
+     * copy constructor, assignment operator and destructor are used
+     */
+    class NameTable {
+    private:
+        vector<string_view> names;
+        vector<size_t> hashes;
+        // Id + 1 of the name in each slot, 0 for empty slots
+        vector<int> slots;
+
+        void grow();
+
+    public:
+        NameTable();
+        friend ostream &operator<<(ostream &out, const NameTable &obj);
+
+        int find(string_view name) const;
+        int intern(string_view name);
+        string_view getName(int id) const;
+        int size() const;
+    };
+
+    ostream &operator<<(ostream &out, const NameTable &obj);
+}
@@ -0,0 +1,219 @@
+#include "Random.h"
+
+#include <cmath>
+
+using cris_utils::Random;
+
+namespace {
+    uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    /**
+     * splitmix64, used to spread a single seed over the whole generator state
+     */
+    uint64_t splitMix(uint64_t &x) {
+        uint64_t z = (x += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+
+    /**
+     * Maps a random 64-bit value to [0, range) with Lemire's multiply-shift, rejecting the few
+     * values which would bias the result
+     */
+    uint64_t bounded(Random &rng, uint64_t x, uint64_t range) {
+        __uint128_t m = static_cast<__uint128_t>(x) * range;
+        uint64_t low = static_cast<uint64_t>(m);
+        if (low < range) {
+            uint64_t threshold = -range % range;
+            while (low < threshold) {
+                m = static_cast<__uint128_t>(rng.next()) * range;
+                low = static_cast<uint64_t>(m);
+            }
+        }
+        return static_cast<uint64_t>(m >> 64);
+    }
+
+    // Below this mean, binomial draws are inverted directly instead of using rejection sampling
+    const double INVERSION_MAX_MEAN = 10;
+
+    /**
+     * Returns log(k!), from a table for small values and Stirling's series otherwise. Unlike
+     * std::lgamma, this doesn't touch any global state, so games can run on separate threads.
+     */
+    double logFactorial(int k) {
+        static const vector<double> table = [] {
+            vector<double> logs(16, 0);
+            for (int i = 2; i < logs.size(); ++i) {
+                logs[i] = logs[i - 1] + std::log(static_cast<double>(i));
+            }
+            return logs;
+        }();
+        if (k < table.size()) {
+            return table[k];
+        }
+        double x = k + 1;
+        double x2 = x * x;
+        return (x - 0.5) * std::log(x) - x + 0.5 * std::log(2 * M_PI)
+               + (1.0 / 12 - (1.0 / 360 - 1.0 / (1260 * x2)) / x2) / x;
+    }
+
+    /**
+     * Samples a binomial by walking its cumulative distribution from 0. Expected time is linear in
+     * the mean, so this is only used when the mean is small.
+     *
+     * @param p success probability, at most 0.5
+     */
+    int binomialInversion(Random &rng, int trials, double p) {
+        double q = 1 - p;
+        double s = p / q;
+        double a = (trials + 1) * s;
+        double start = std::pow(q, trials);
+        while (true) {
+            double r = start;
+            double u = rng.nextDouble();
+            int k = 0;
+            while (u > r && k <= trials) {
+                u -= r;
+                k++;
+                r *= a / k - s;
+            }
+            // Rounding can leave u above the total mass, in which case the draw is retried
+            if (k <= trials) {
+                return k;
+            }
+        }
+    }
+
+    /**
+     * Samples a binomial with Hormann's BTRS rejection algorithm, which takes constant expected time.
+     *
+     * W. Hormann, "The generation of binomial random variates", 1993
+     *
+     * @param p success probability, at most 0.5
+     */
+    int binomialRejection(Random &rng, int trials, double p) {
+        double q = 1 - p;
+        double spq = std::sqrt(trials * p * q);
+        double b = 1.15 + 2.53 * spq;
+        double a = -0.0873 + 0.0248 * b + 0.01 * p;
+        double c = trials * p + 0.5;
+        double vr = 0.92 - 4.2 / b;
+        double alpha = (2.83 + 5.1 / b) * spq;
+        double lpq = std::log(p / q);
+        int m = static_cast<int>((trials + 1) * p);
+        double h = logFactorial(m) + logFactorial(trials - m);
+
+        while (true) {
+            double u = rng.nextDouble() - 0.5;
+            double v = rng.nextDouble();
+            double us = 0.5 - std::fabs(u);
+            // u is -0.5 once in 2^53 draws, which would divide by zero below
+            if (us == 0) {
+                continue;
+            }
+            int k = static_cast<int>(std::floor((2 * a / us + b) * u + c));
+            if (k < 0 || k > trials) {
+                continue;
+            }
+            if (us >= 0.07 && v <= vr) {
+                return k;
+            }
+            v = std::log(v * alpha / (a / (us * us) + b));
+            if (v <= h - logFactorial(k) - logFactorial(trials - k) + (k - m) * lpq) {
+                return k;
+            }
+        }
+    }
+}
+
+Random::Random(uint64_t seed) : state{} {
+    this->seed(seed);
+}
+
+ostream &cris_utils::operator<<(ostream &out, const Random &obj) {
+    out << "Random{ xoshiro256** }";
+    return out;
+}
+
+void Random::seed(uint64_t seed) {
+    for (auto &word : state) {
+        word = splitMix(seed);
+    }
+}
+
+uint64_t Random::next() {
+    uint64_t result = rotl(state[1] * 5, 7) * 9;
+    uint64_t t = state[1] << 17;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+
+    return result;
+}
+
+/**
+ * Returns a uniformly distributed integer
+ *
+ * @param min smallest possible value
+ * @param max largest possible value, inclusive
+ */
+int Random::nextInt(int min, int max) {
+    uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1;
+    return static_cast<int>(min + static_cast<int64_t>(bounded(*this, next(), range)));
+}
+
+/**
+ * Returns a uniformly distributed double in [0, 1)
+ */
+double Random::nextDouble() {
+    return static_cast<double>(next() >> 11) * 0x1.0p-53;
+}
+
+/**
+ * Fills a buffer with uniformly distributed integers
+ *
+ * @param out buffer receiving the values
+ * @param count number of values to generate
+ * @param min smallest possible value
+ * @param max largest possible value, inclusive
+ */
+void Random::fill(int *out, int count, int min, int max) {
+    uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1;
+    for (int i = 0; i < count; ++i) {
+        out[i] = static_cast<int>(min + static_cast<int64_t>(bounded(*this, next(), range)));
+    }
+}
+
+/**
+ * Returns the number of successes out of independent trials, each with the same probability.
+ *
+ * Takes constant expected time however many trials there are, so it can replace rolling once
+ * per trial.
+ *
+ * @param trials number of trials
+ * @param p probability of success of each trial
+ * @return number of successes, between 0 and trials
+ */
+int Random::binomial(int trials, double p) {
+    if (trials <= 0 || p <= 0) {
+        return 0;
+    }
+    if (p >= 1) {
+        return trials;
+    }
+    // Both algorithms expect the less likely outcome to be counted
+    if (p > 0.5) {
+        return trials - binomial(trials, 1 - p);
+    }
+    if (trials * p < INVERSION_MAX_MEAN) {
+        return binomialInversion(*this, trials, p);
+    }
+    return binomialRejection(*this, trials, p);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+using std::ostream;
+using std::vector;
+
+namespace cris_utils {
+    /**
+     * Seedable xoshiro256** pseudo-random generator.
+     *
+     * Every game owns one, so games are reproducible from a single 64-bit seed and never contend
+     * over shared state. Bounded integers are drawn without modulo bias, and bulk fills let callers
+     * draw many rolls at once in a tight loop.
+     *
+     * Satisfies UniformRandomBitGenerator, so it can also drive the standard library's algorithms.
+     *
+     * Note that since this class doesn't have pointer attributes, the default
+     * copy constructor, assignment operator and destructor are used
+     */
+    class Random {
+    private:
+        uint64_t state[4];
+
+    public:
+        typedef uint64_t result_type;
+
+        explicit Random(uint64_t seed = 0);
+        friend ostream &operator<<(ostream &out, const Random &obj);
+
+        void seed(uint64_t seed);
+        uint64_t next();
+        int nextInt(int min, int max);
+        double nextDouble();
+        void fill(int *out, int count, int min, int max);
+        int binomial(int trials, double p);
+
+        /**
+         * Shuffles a vector in place with Fisher-Yates, so the result only depends on the seed and not
+         * on the standard library's distributions
+         */
+        template<typename T>
+        void shuffle(vector<T> &v) {
+            for (int i = v.size() - 1; i > 0; --i) {
+                std::swap(v[i], v[nextInt(0, i)]);
+            }
+        }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return UINT64_MAX; }
+        result_type operator()() { return next(); }
+    };
+
+    ostream &operator<<(ostream &out, const Random &obj);
+}
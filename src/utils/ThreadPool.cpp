@@ -0,0 +1,159 @@
+#include "ThreadPool.h"
+
+using std::unique_lock;
+using std::lock_guard;
+using std::mutex;
+
+using cris_utils::ThreadPool;
+
+namespace {
+    // Pool and queue index of the worker running on the current thread, if any
+    thread_local const ThreadPool *currentPool = nullptr;
+    thread_local int currentWorker = -1;
+}
+
+/**
+ * Starts the worker threads
+ *
+ * @param numThreads number of workers. At least one is started
+ */
+ThreadPool::ThreadPool(int numThreads)
+        : workers{},
+          queues{},
+          queued{0},
+          pending{0},
+          nextQueue{0},
+          stopping{false} {
+    if (numThreads < 1) {
+        numThreads = 1;
+    }
+    for (int i = 0; i < numThreads; ++i) {
+        queues.push_back(new WorkQueue());
+    }
+    for (int i = 0; i < numThreads; ++i) {
+        workers.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+/**
+ * Runs tasks until the pool is destroyed
+ *
+ * @param index index of the worker's queue
+ */
+void ThreadPool::work(int index) {
+    currentPool = this;
+    currentWorker = index;
+    while (true) {
+        function<void()> task;
+        if (!takeTask(index, task)) {
+            unique_lock<mutex> lock(tasksMutex);
+            taskAvailable.wait(lock, [this] { return stopping || queued > 0; });
+            if (queued == 0) {
+                return;
+            }
+            continue;
+        }
+
+        task();
+
+        unique_lock<mutex> lock(tasksMutex);
+        if (--pending == 0) {
+            allDone.notify_all();
+        }
+    }
+}
+
+/**
+ * Takes the newest task of a worker's queue, or else steals the oldest task of another queue
+ *
+ * @param index index of the worker's queue
+ * @param task receives the task
+ * @return whether a task was found
+ */
+bool ThreadPool::takeTask(int index, function<void()> &task) {
+    for (int i = 0; i < queues.size(); ++i) {
+        WorkQueue *queue = queues[(index + i) % queues.size()];
+        {
+            lock_guard<mutex> lock(queue->mutex);
+            if (queue->tasks.empty()) {
+                continue;
+            }
+            if (i == 0) {
+                task = std::move(queue->tasks.back());
+                queue->tasks.pop_back();
+            } else {
+                task = std::move(queue->tasks.front());
+                queue->tasks.pop_front();
+            }
+        }
+        lock_guard<mutex> lock(tasksMutex);
+        queued--;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Queues a task to be run by one of the workers
+ *
+ * @param task
+ */
+void ThreadPool::submit(function<void()> task) {
+    int index;
+    {
+        lock_guard<mutex> lock(tasksMutex);
+        if (currentPool == this) {
+            index = currentWorker;
+        } else {
+            index = nextQueue;
+            nextQueue = (nextQueue + 1) % queues.size();
+        }
+        pending++;
+    }
+    {
+        lock_guard<mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        lock_guard<mutex> lock(tasksMutex);
+        queued++;
+    }
+    taskAvailable.notify_one();
+}
+
+/**
+ * Blocks until every submitted task has finished running
+ */
+void ThreadPool::wait() {
+    unique_lock<mutex> lock(tasksMutex);
+    allDone.wait(lock, [this] { return pending == 0; });
+}
+
+int ThreadPool::size() const {
+    return workers.size();
+}
+
+/**
+ * Finishes the queued tasks, then stops the workers
+ */
+ThreadPool::~ThreadPool() {
+    {
+        unique_lock<mutex> lock(tasksMutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (auto &queue : queues) {
+        delete queue;
+    }
+}
+
+/**
+ * Returns the number of threads the hardware can run concurrently, or 1 if it is unknown
+ */
+int cris_utils::hardwareThreads() {
+    int threads = std::thread::hardware_concurrency();
+    return threads > 0 ? threads : 1;
+}
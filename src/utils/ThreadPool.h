@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::function;
+using std::vector;
+
+namespace cris_utils {
+    /**
+     * Fixed set of worker threads running submitted tasks, balanced by work stealing.
+     *
+     * Every worker has its own queue. Tasks submitted from outside the pool are dealt to the queues in
+     * turn, and tasks submitted by a running task go to its worker's queue. A worker runs the newest
+     * task of its own queue first, and when it runs out, steals the oldest task of another queue, so
+     * uneven tasks are spread over the workers without a single contended queue.
+     *
+     * Worker threads can't be copied, so neither can the pool.
+     */
+    class ThreadPool {
+    private:
+        /**
+         * Tasks waiting for one worker
+         */
+        struct WorkQueue {
+            std::mutex mutex;
+            std::deque<function<void()>> tasks;
+        };
+
+        vector<std::thread> workers;
+        vector<WorkQueue *> queues;
+        // Guards the counters below, and is used to sleep while there's nothing to run
+        std::mutex tasksMutex;
+        std::condition_variable taskAvailable;
+        std::condition_variable allDone;
+        // Tasks waiting in the queues
+        int queued;
+        // Tasks submitted and not finished yet
+        int pending;
+        int nextQueue;
+        bool stopping;
+
+        void work(int index);
+        bool takeTask(int index, function<void()> &task);
+
+    public:
+        explicit ThreadPool(int numThreads);
+        ThreadPool(const ThreadPool &other) = delete;
+        ThreadPool &operator=(const ThreadPool &other) = delete;
+
+        void submit(function<void()> task);
+        void wait();
+        int size() const;
+
+        ~ThreadPool();
+    };
+
+    int hardwareThreads();
+}
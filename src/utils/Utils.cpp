@@ -1,5 +1,8 @@
 #include "Utils.h"
 
+#include <cctype>
+#include <charconv>
+
 using std::find;
 using std::vector;
 using std::string;
@@ -9,8 +12,6 @@ using std::end;
 using std::endl;
 
 namespace {
-    bool seedSet = false;
-
     void ltrim(string &s) {
         s.erase(s.begin(), find_if(s.begin(), s.end(), [](unsigned char ch) {
             return !isspace(ch);
@@ -27,21 +28,22 @@ namespace {
 /**
  * Splits a string given a delimiter
  *
- * Implementation taken from
+ * Implementation adapted from
  * https://stackoverflow.com/questions/14265581/parse-split-a-string-in-c-using-string-delimiter-standard-c
  *
  * @param str
  * @param delimiter
  * @return vector of tokens
  */
-vector<string> cris_utils::strSplit(string str, const string &delimiter) {
+vector<string> cris_utils::strSplit(const string &str, const string &delimiter) {
     vector<string> result;
+    size_t start = 0;
     size_t pos;
-    while ((pos = str.find(delimiter)) != string::npos) {
-        result.push_back(str.substr(0, pos));
-        str.erase(0, pos + delimiter.length());
+    while ((pos = str.find(delimiter, start)) != string::npos) {
+        result.push_back(str.substr(start, pos - start));
+        start = pos + delimiter.length();
     }
-    result.push_back(str);
+    result.push_back(str.substr(start));
     return result;
 }
 
@@ -74,6 +76,61 @@ bool cris_utils::isNumber(const string &str) {
     return !str.empty() && it == str.end();
 }
 
+/**
+ * Splits a string given a delimiter, without copying it. Like strSplit, consecutive delimiters give
+ * empty tokens
+ *
+ * The tokens are views into the string, so they are only valid as long as the string is. The token
+ * vector is cleared first, so it can be reused from one line to the next without allocating.
+ *
+ * @param str
+ * @param delimiter
+ * @param tokens receives the tokens
+ */
+void cris_utils::splitView(string_view str, char delimiter, vector<string_view> &tokens) {
+    tokens.clear();
+    size_t start = 0;
+    size_t pos;
+    while ((pos = str.find(delimiter, start)) != string_view::npos) {
+        tokens.push_back(str.substr(start, pos - start));
+        start = pos + 1;
+    }
+    tokens.push_back(str.substr(start));
+}
+
+/**
+ * Trims a string of whitespace, without copying it
+ *
+ * @param str
+ * @return view of the string without its leading and trailing whitespace
+ */
+string_view cris_utils::trimView(string_view str) {
+    size_t first = 0;
+    while (first < str.size() && isspace(static_cast<unsigned char>(str[first]))) {
+        first++;
+    }
+    size_t last = str.size();
+    while (last > first && isspace(static_cast<unsigned char>(str[last - 1]))) {
+        last--;
+    }
+    return str.substr(first, last - first);
+}
+
+/**
+ * Parses a number. Like isNumber, only digits are accepted
+ *
+ * @param str
+ * @param value receives the number
+ * @return whether the whole string is a number which fits in an int
+ */
+bool cris_utils::parseInt(string_view str, int &value) {
+    if (str.empty() || !isdigit(static_cast<unsigned char>(str[0]))) {
+        return false;
+    }
+    auto result = std::from_chars(str.data(), str.data() + str.size(), value);
+    return result.ec == std::errc() && result.ptr == str.data() + str.size();
+}
+
 /**
  * Prompts the user for a number
  * @param prompt
@@ -138,27 +195,23 @@ void cris_utils::getContinueInput() {
     getchar();
 }
 
-void cris_utils::printTitle(string title) {
-    cout << endl
+void cris_utils::printTitle(string title, ostream &out) {
+    out << endl
          << "==========================================================" << endl
          << title << endl
          << "==========================================================" << endl << endl;
 }
 
-void cris_utils::printSubtitle(string title) {
-    cout << endl
+void cris_utils::printSubtitle(string title, ostream &out) {
+    out << endl
          << "============== " <<
          title
          << " ==============" << endl << endl;
 }
 
 /**
- * Generate random number between min and max
+ * Generate random number between min and max, using the given engine
  */
-int cris_utils::randInt(int min, int max) {
-    if (!seedSet) {
-        srand((unsigned int) time(nullptr));
-        seedSet = true;
-    }
-    return (rand() % (max - min + 1)) + min;
+int cris_utils::randInt(int min, int max, Random &rng) {
+    return rng.nextInt(min, max);
 }
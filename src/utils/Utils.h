@@ -1,13 +1,17 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <iostream>
 #include <set>
 #include <algorithm>
 #include <map>
 
+#include "Random.h"
+
 using std::string;
+using std::string_view;
 using std::vector;
 using std::ostream;
 using std::set;
@@ -85,9 +89,34 @@ namespace cris_utils {
         return s1 == s2;
     }
 
-    vector<string> strSplit(string str, const string &delimiter);
+    /**
+     * Non-owning view over a contiguous range of elements.
+     *
+     * Used to expose internal arrays without copying them. The view is only valid as long as the
+     * underlying storage isn't modified.
+     */
+    template<typename T>
+    class Span {
+    private:
+        const T *first;
+        const T *last;
+    public:
+        Span() : first{nullptr}, last{nullptr} {}
+        Span(const T *first, const T *last) : first{first}, last{last} {}
+
+        const T *begin() const { return first; }
+        const T *end() const { return last; }
+        int size() const { return last - first; }
+        bool empty() const { return first == last; }
+        const T &operator[](int i) const { return first[i]; }
+    };
+
+    vector<string> strSplit(const string &str, const string &delimiter);
     void trim(std::string &s);
     bool isNumber(const string &str);
+    void splitView(string_view str, char delimiter, vector<string_view> &tokens);
+    string_view trimView(string_view str);
+    bool parseInt(string_view str, int &value);
 
     /**
      * Remove element from vector
@@ -109,22 +138,22 @@ namespace cris_utils {
     bool getBoolInput(string prompt);
     void getContinueInput();
 
-    void printTitle(string title);
-    void printSubtitle(string title);
+    void printTitle(string title, ostream &out = cout);
+    void printSubtitle(string title, ostream &out = cout);
 
-    int randInt(int min, int max);
+    int randInt(int min, int max, Random &rng);
 
     template<typename T>
-    void printList(vector<T> list) {
+    void printList(vector<T> list, ostream &out = cout) {
         for (int i = 0; i < list.size(); ++i) {
-            cout << "\t" << (i + 1) << ": " << list[i] << endl;
+            out << "\t" << (i + 1) << ": " << list[i] << endl;
         }
     }
 
     template<typename T>
-    void printList(vector<T *> list) {
+    void printList(vector<T *> list, ostream &out = cout) {
         for (int i = 0; i < list.size(); ++i) {
-            cout << "\t" << (i + 1) << ": " << *(list[i]) << endl;
+            out << "\t" << (i + 1) << ": " << *(list[i]) << endl;
         }
     }
 